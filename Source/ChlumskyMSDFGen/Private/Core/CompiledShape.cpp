@@ -0,0 +1,572 @@
+
+#include "CompiledShape.h"
+
+#include <cmath>
+#include <algorithm>
+#include "arithmetics.hpp"
+#include "equation-solver.h"
+#include "Math/VectorRegister.h"
+
+namespace msdfgen {
+
+// The kernels below repeat the arithmetic of the EdgeSegment::signedDistance implementations operation for operation, so that in double precision both produce the same distances
+using std::fabs;
+using std::sqrt;
+
+template <typename Real>
+struct LaneTraits;
+
+template <>
+struct LaneTraits<double> {
+    typedef VectorRegister4Double Lanes;
+
+    static FORCEINLINE Lanes set(double a, double b, double c, double d) {
+        return MakeVectorRegisterDouble(a, b, c, d);
+    }
+    static FORCEINLINE Lanes zero() {
+        return VectorZeroDouble();
+    }
+};
+
+template <>
+struct LaneTraits<float> {
+    typedef VectorRegister4Float Lanes;
+
+    static FORCEINLINE Lanes set(float a, float b, float c, float d) {
+        return MakeVectorRegisterFloat(a, b, c, d);
+    }
+    static FORCEINLINE Lanes zero() {
+        return VectorZeroFloat();
+    }
+};
+
+static_assert(CompiledShapeBase::BATCH_SIZE == 4, "Batches fill the four lanes of a vector register");
+
+template <typename Real>
+static FORCEINLINE typename LaneTraits<Real>::Lanes broadcast(Real value) {
+    return LaneTraits<Real>::set(value, value, value, value);
+}
+
+template <typename Real>
+static FORCEINLINE typename LaneTraits<Real>::Lanes gather(const std::vector<Real> &values, const int indices[CompiledShapeBase::BATCH_SIZE]) {
+    return LaneTraits<Real>::set(values[indices[0]], values[indices[1]], values[indices[2]], values[indices[3]]);
+}
+
+template <typename Lanes>
+static FORCEINLINE Lanes lanesDot(const Lanes &ax, const Lanes &ay, const Lanes &bx, const Lanes &by) {
+    return VectorAdd(VectorMultiply(ax, bx), VectorMultiply(ay, by));
+}
+
+template <typename Lanes>
+static FORCEINLINE Lanes lanesCross(const Lanes &ax, const Lanes &ay, const Lanes &bx, const Lanes &by) {
+    return VectorSubtract(VectorMultiply(ax, by), VectorMultiply(ay, bx));
+}
+
+template <typename Lanes>
+static FORCEINLINE Lanes lanesLength(const Lanes &x, const Lanes &y) {
+    return VectorSqrt(lanesDot(x, y, x, y));
+}
+
+template <typename Real>
+static FORCEINLINE typename LaneTraits<Real>::Lanes lanesNonZeroSign(const typename LaneTraits<Real>::Lanes &value) {
+    return VectorSelect(VectorCompareGT(value, LaneTraits<Real>::zero()), broadcast<Real>(1), broadcast<Real>(-1));
+}
+
+/// Equivalent to Vector2::normalize(false).
+template <typename Real>
+static FORCEINLINE void lanesNormalize(const typename LaneTraits<Real>::Lanes &x, const typename LaneTraits<Real>::Lanes &y, typename LaneTraits<Real>::Lanes &nx, typename LaneTraits<Real>::Lanes &ny) {
+    typename LaneTraits<Real>::Lanes length = lanesLength(x, y);
+    typename LaneTraits<Real>::Lanes zero = VectorCompareEQ(length, LaneTraits<Real>::zero());
+    nx = VectorSelect(zero, LaneTraits<Real>::zero(), VectorDivide(x, length));
+    ny = VectorSelect(zero, broadcast<Real>(1), VectorDivide(y, length));
+}
+
+template <typename Real>
+static FORCEINLINE typename LaneTraits<Real>::Lanes lanesInOpenUnitInterval(const typename LaneTraits<Real>::Lanes &value) {
+    return VectorBitwiseAnd(VectorCompareGT(value, LaneTraits<Real>::zero()), VectorCompareLT(value, broadcast<Real>(1)));
+}
+
+template <typename Real>
+static FORCEINLINE void storeSignedDistances(const typename LaneTraits<Real>::Lanes &distance, const typename LaneTraits<Real>::Lanes &dot, const typename LaneTraits<Real>::Lanes &param, const int slots[CompiledShapeBase::BATCH_SIZE], int count, SignedDistance *distances, double *params) {
+    Real distanceLanes[CompiledShapeBase::BATCH_SIZE], dotLanes[CompiledShapeBase::BATCH_SIZE], paramLanes[CompiledShapeBase::BATCH_SIZE];
+    VectorStore(distance, distanceLanes);
+    VectorStore(dot, dotLanes);
+    VectorStore(param, paramLanes);
+    for (int i = 0; i < count; ++i) {
+        distances[slots[i]] = SignedDistance(distanceLanes[i], dotLanes[i]);
+        params[slots[i]] = paramLanes[i];
+    }
+}
+
+/// LinearSegment::signedDistance of the edges at indices in each lane.
+template <typename Real>
+static void linearSignedDistance(const typename LaneTraits<Real>::Lanes &qx, const typename LaneTraits<Real>::Lanes &qy, const typename CompiledShape<Real>::LinearEdges &edges, const int indices[CompiledShapeBase::BATCH_SIZE], typename LaneTraits<Real>::Lanes &distance, typename LaneTraits<Real>::Lanes &dot, typename LaneTraits<Real>::Lanes &param) {
+    typedef typename LaneTraits<Real>::Lanes Lanes;
+    const Lanes zero = LaneTraits<Real>::zero();
+    Lanes p0x = gather(edges.p0.x, indices), p0y = gather(edges.p0.y, indices);
+    Lanes p1x = gather(edges.p1.x, indices), p1y = gather(edges.p1.y, indices);
+    Lanes aqx = VectorSubtract(qx, p0x), aqy = VectorSubtract(qy, p0y);
+    Lanes abx = VectorSubtract(p1x, p0x), aby = VectorSubtract(p1y, p0y);
+    param = VectorDivide(lanesDot(aqx, aqy, abx, aby), lanesDot(abx, aby, abx, aby));
+    Lanes nearEnd = VectorCompareGT(param, broadcast<Real>(.5));
+    Lanes eqx = VectorSubtract(VectorSelect(nearEnd, p1x, p0x), qx);
+    Lanes eqy = VectorSubtract(VectorSelect(nearEnd, p1y, p0y), qy);
+    Lanes endpointDistance = lanesLength(eqx, eqy);
+
+    // ab.getOrthonormal(false)
+    Lanes abLength = lanesLength(abx, aby);
+    Lanes abZero = VectorCompareEQ(abLength, zero);
+    Lanes orthoX = VectorSelect(abZero, zero, VectorDivide(aby, abLength));
+    Lanes orthoY = VectorSelect(abZero, broadcast<Real>(-1), VectorDivide(VectorNegate(abx), abLength));
+    Lanes orthoDistance = lanesDot(orthoX, orthoY, aqx, aqy);
+    Lanes orthogonal = VectorBitwiseAnd(lanesInOpenUnitInterval<Real>(param), VectorCompareLT(VectorAbs(orthoDistance), endpointDistance));
+
+    Lanes abnx, abny, eqnx, eqny;
+    lanesNormalize<Real>(abx, aby, abnx, abny);
+    lanesNormalize<Real>(eqx, eqy, eqnx, eqny);
+    distance = VectorSelect(orthogonal, orthoDistance, VectorMultiply(lanesNonZeroSign<Real>(lanesCross(aqx, aqy, abx, aby)), endpointDistance));
+    dot = VectorSelect(orthogonal, zero, VectorAbs(lanesDot(abnx, abny, eqnx, eqny)));
+}
+
+/// qe = qa+3*t*ab+3*t*t*br+t*t*t*as
+template <typename Real>
+static FORCEINLINE void cubicOffset(const typename LaneTraits<Real>::Lanes &t, const typename LaneTraits<Real>::Lanes &qax, const typename LaneTraits<Real>::Lanes &qay, const typename LaneTraits<Real>::Lanes &abx, const typename LaneTraits<Real>::Lanes &aby, const typename LaneTraits<Real>::Lanes &brx, const typename LaneTraits<Real>::Lanes &bry, const typename LaneTraits<Real>::Lanes &asx, const typename LaneTraits<Real>::Lanes &asy, typename LaneTraits<Real>::Lanes &qex, typename LaneTraits<Real>::Lanes &qey) {
+    typedef typename LaneTraits<Real>::Lanes Lanes;
+    Lanes t3 = VectorMultiply(broadcast<Real>(3), t);
+    Lanes t3t = VectorMultiply(t3, t);
+    Lanes ttt = VectorMultiply(VectorMultiply(t, t), t);
+    qex = VectorAdd(VectorAdd(VectorAdd(qax, VectorMultiply(t3, abx)), VectorMultiply(t3t, brx)), VectorMultiply(ttt, asx));
+    qey = VectorAdd(VectorAdd(VectorAdd(qay, VectorMultiply(t3, aby)), VectorMultiply(t3t, bry)), VectorMultiply(ttt, asy));
+}
+
+/// d1 = 3*ab+6*t*br+3*t*t*as
+template <typename Real>
+static FORCEINLINE void cubicDirection(const typename LaneTraits<Real>::Lanes &t, const typename LaneTraits<Real>::Lanes &abx, const typename LaneTraits<Real>::Lanes &aby, const typename LaneTraits<Real>::Lanes &brx, const typename LaneTraits<Real>::Lanes &bry, const typename LaneTraits<Real>::Lanes &asx, const typename LaneTraits<Real>::Lanes &asy, typename LaneTraits<Real>::Lanes &d1x, typename LaneTraits<Real>::Lanes &d1y) {
+    typedef typename LaneTraits<Real>::Lanes Lanes;
+    Lanes t6 = VectorMultiply(broadcast<Real>(6), t);
+    Lanes t3t = VectorMultiply(VectorMultiply(broadcast<Real>(3), t), t);
+    d1x = VectorAdd(VectorAdd(VectorMultiply(broadcast<Real>(3), abx), VectorMultiply(t6, brx)), VectorMultiply(t3t, asx));
+    d1y = VectorAdd(VectorAdd(VectorMultiply(broadcast<Real>(3), aby), VectorMultiply(t6, bry)), VectorMultiply(t3t, asy));
+}
+
+/// dot(d1, d1)+dot(qe, d2) where d2 = 6*br+6*t*as, the derivative of the slope dot(qe, d1)
+template <typename Real>
+static FORCEINLINE typename LaneTraits<Real>::Lanes cubicSlopeDerivative(const typename LaneTraits<Real>::Lanes &t, const typename LaneTraits<Real>::Lanes &qex, const typename LaneTraits<Real>::Lanes &qey, const typename LaneTraits<Real>::Lanes &d1x, const typename LaneTraits<Real>::Lanes &d1y, const typename LaneTraits<Real>::Lanes &brx, const typename LaneTraits<Real>::Lanes &bry, const typename LaneTraits<Real>::Lanes &asx, const typename LaneTraits<Real>::Lanes &asy) {
+    typedef typename LaneTraits<Real>::Lanes Lanes;
+    Lanes t6 = VectorMultiply(broadcast<Real>(6), t);
+    Lanes d2x = VectorAdd(VectorMultiply(broadcast<Real>(6), brx), VectorMultiply(t6, asx));
+    Lanes d2y = VectorAdd(VectorMultiply(broadcast<Real>(6), bry), VectorMultiply(t6, asy));
+    return VectorAdd(lanesDot(d1x, d1y, d1x, d1y), lanesDot(qex, qey, d2x, d2y));
+}
+
+/// t-dot(qe, d1)/(dot(d1, d1)+dot(qe, d2))
+template <typename Real>
+static FORCEINLINE typename LaneTraits<Real>::Lanes cubicNewtonStep(const typename LaneTraits<Real>::Lanes &t, const typename LaneTraits<Real>::Lanes &qex, const typename LaneTraits<Real>::Lanes &qey, const typename LaneTraits<Real>::Lanes &d1x, const typename LaneTraits<Real>::Lanes &d1y, const typename LaneTraits<Real>::Lanes &brx, const typename LaneTraits<Real>::Lanes &bry, const typename LaneTraits<Real>::Lanes &asx, const typename LaneTraits<Real>::Lanes &asy) {
+    return VectorSubtract(t, VectorDivide(lanesDot(qex, qey, d1x, d1y), cubicSlopeDerivative<Real>(t, qex, qey, d1x, d1y, brx, bry, asx, asy)));
+}
+
+/// Searches the sections of the edges at indices in each lane for their closest points (see GeneratorConfig::BRACKETED_CUBIC_SEARCH), and updates minDistance and param where they are nearer.
+/// A section brackets a closest point if the distance decreases at its start and increases at its end. The bracket narrows with every step, and Newton steps that would leave it are replaced by bisection.
+/// Where the slope is exactly zero at a bound, as on the axis of a symmetric curve, the bound is a candidate itself, and the sign of the slope just inside each neighbouring section follows the slope's derivative.
+template <typename Real>
+static void cubicBracketedSearch(const typename CompiledShape<Real>::CubicEdges &edges, const int indices[CompiledShapeBase::BATCH_SIZE], const typename LaneTraits<Real>::Lanes &qax, const typename LaneTraits<Real>::Lanes &qay, const typename LaneTraits<Real>::Lanes &abx, const typename LaneTraits<Real>::Lanes &aby, const typename LaneTraits<Real>::Lanes &brx, const typename LaneTraits<Real>::Lanes &bry, const typename LaneTraits<Real>::Lanes &asx, const typename LaneTraits<Real>::Lanes &asy, typename LaneTraits<Real>::Lanes &minDistance, typename LaneTraits<Real>::Lanes &param) {
+    typedef typename LaneTraits<Real>::Lanes Lanes;
+    const Lanes zero = LaneTraits<Real>::zero();
+    int sectionCounts[CompiledShapeBase::BATCH_SIZE], boundIndices[CompiledShapeBase::BATCH_SIZE];
+    int maxSectionCount = 0;
+    for (int i = 0; i < CompiledShapeBase::BATCH_SIZE; ++i) {
+        maxSectionCount = std::max(maxSectionCount, sectionCounts[i] = edges.sectionCounts[indices[i]]);
+        boundIndices[i] = CompiledShape<Real>::CUBIC_SECTION_BOUNDS_CAPACITY*indices[i];
+    }
+    Lanes sectionCountLanes = LaneTraits<Real>::set(Real(sectionCounts[0]), Real(sectionCounts[1]), Real(sectionCounts[2]), Real(sectionCounts[3]));
+
+    // The slope is the derivative of half the squared distance, dot(qe, d1)
+    Lanes qex, qey, d1x, d1y;
+    Lanes lo = gather(edges.sectionBounds, boundIndices);
+    cubicOffset<Real>(lo, qax, qay, abx, aby, brx, bry, asx, asy, qex, qey);
+    cubicDirection<Real>(lo, abx, aby, brx, bry, asx, asy, d1x, d1y);
+    Lanes loSlope = lanesDot(qex, qey, d1x, d1y);
+    Lanes loSlopeDerivative = cubicSlopeDerivative<Real>(lo, qex, qey, d1x, d1y, brx, bry, asx, asy);
+    for (int section = 0; section < maxSectionCount; ++section) {
+        for (int i = 0; i < CompiledShapeBase::BATCH_SIZE; ++i)
+            ++boundIndices[i];
+        Lanes active = VectorCompareLT(broadcast<Real>(Real(section)), sectionCountLanes);
+        Lanes hi = gather(edges.sectionBounds, boundIndices);
+        cubicOffset<Real>(hi, qax, qay, abx, aby, brx, bry, asx, asy, qex, qey);
+        cubicDirection<Real>(hi, abx, aby, brx, bry, asx, asy, d1x, d1y);
+        Lanes hiSlope = lanesDot(qex, qey, d1x, d1y);
+        Lanes hiSlopeDerivative = cubicSlopeDerivative<Real>(hi, qex, qey, d1x, d1y, brx, bry, asx, asy);
+        Lanes loFlat = VectorCompareEQ(loSlope, zero);
+        Lanes hiFlat = VectorCompareEQ(hiSlope, zero);
+        Lanes hiCandidate = VectorBitwiseAnd(active, hiFlat);
+        if (VectorMaskBits(hiCandidate)) {
+            Lanes boundDistance = lanesLength(qex, qey);
+            Lanes nearer = VectorBitwiseAnd(hiCandidate, VectorCompareLT(boundDistance, VectorAbs(minDistance)));
+            minDistance = VectorSelect(nearer, VectorMultiply(lanesNonZeroSign<Real>(lanesCross(d1x, d1y, qex, qey)), boundDistance), minDistance);
+            param = VectorSelect(nearer, hi, param);
+        }
+        Lanes loSign = VectorSelect(loFlat, loSlopeDerivative, loSlope);
+        Lanes hiSign = VectorSelect(hiFlat, VectorNegate(hiSlopeDerivative), hiSlope);
+        Lanes bracketed = VectorBitwiseAnd(active, VectorBitwiseAnd(VectorCompareLT(loSign, zero), VectorCompareGT(hiSign, zero)));
+        if (VectorMaskBits(bracketed)) {
+            // The first guess is where the slope would be zero if it were linear between the bounds, or the middle if either bound is flat, as that guess would stay on the bound
+            Lanes a = lo, b = hi;
+            Lanes flat = VectorBitwiseOr(loFlat, hiFlat);
+            Lanes t = VectorSelect(flat, VectorMultiply(broadcast<Real>(Real(.5)), VectorAdd(a, b)), VectorAdd(a, VectorMultiply(VectorSubtract(b, a), VectorDivide(loSlope, VectorSelect(flat, broadcast<Real>(-1), VectorSubtract(loSlope, hiSlope))))));
+            for (int step = 0; step < MSDFGEN_CUBIC_SEARCH_STEPS; ++step) {
+                cubicOffset<Real>(t, qax, qay, abx, aby, brx, bry, asx, asy, qex, qey);
+                cubicDirection<Real>(t, abx, aby, brx, bry, asx, asy, d1x, d1y);
+                Lanes beforeMinimum = VectorCompareLT(lanesDot(qex, qey, d1x, d1y), zero);
+                a = VectorSelect(beforeMinimum, t, a);
+                b = VectorSelect(beforeMinimum, b, t);
+                Lanes improvedT = cubicNewtonStep<Real>(t, qex, qey, d1x, d1y, brx, bry, asx, asy);
+                Lanes inBracket = VectorBitwiseAnd(VectorCompareGE(improvedT, a), VectorCompareLE(improvedT, b));
+                t = VectorSelect(inBracket, improvedT, VectorMultiply(broadcast<Real>(Real(.5)), VectorAdd(a, b)));
+            }
+            cubicOffset<Real>(t, qax, qay, abx, aby, brx, bry, asx, asy, qex, qey);
+            cubicDirection<Real>(t, abx, aby, brx, bry, asx, asy, d1x, d1y);
+            Lanes searchDistance = lanesLength(qex, qey);
+            Lanes nearer = VectorBitwiseAnd(bracketed, VectorCompareLT(searchDistance, VectorAbs(minDistance)));
+            minDistance = VectorSelect(nearer, VectorMultiply(lanesNonZeroSign<Real>(lanesCross(d1x, d1y, qex, qey)), searchDistance), minDistance);
+            param = VectorSelect(nearer, t, param);
+        }
+        lo = hi;
+        loSlope = hiSlope;
+        loSlopeDerivative = hiSlopeDerivative;
+    }
+}
+
+/// CubicSegment::signedDistance of the edges at indices in each lane. With the uniform search, each lane refines its own search and drops out of the Newton iteration when the scalar search would stop.
+template <typename Real>
+static void cubicSignedDistance(const typename LaneTraits<Real>::Lanes &qx, const typename LaneTraits<Real>::Lanes &qy, const typename CompiledShape<Real>::CubicEdges &edges, GeneratorConfig::CubicSearch cubicSearch, const int indices[CompiledShapeBase::BATCH_SIZE], typename LaneTraits<Real>::Lanes &distance, typename LaneTraits<Real>::Lanes &dot, typename LaneTraits<Real>::Lanes &param) {
+    typedef typename LaneTraits<Real>::Lanes Lanes;
+    const Lanes zero = LaneTraits<Real>::zero();
+    Lanes qax = VectorSubtract(gather(edges.p0.x, indices), qx), qay = VectorSubtract(gather(edges.p0.y, indices), qy);
+    Lanes abx = gather(edges.ab.x, indices), aby = gather(edges.ab.y, indices);
+    Lanes brx = gather(edges.br.x, indices), bry = gather(edges.br.y, indices);
+    Lanes asx = gather(edges.as.x, indices), asy = gather(edges.as.y, indices);
+    Lanes startDirX = gather(edges.startDir.x, indices), startDirY = gather(edges.startDir.y, indices);
+    Lanes endDirX = gather(edges.endDir.x, indices), endDirY = gather(edges.endDir.y, indices);
+    Lanes bqx = VectorSubtract(gather(edges.p3.x, indices), qx), bqy = VectorSubtract(gather(edges.p3.y, indices), qy);
+
+    Lanes minDistance = VectorMultiply(lanesNonZeroSign<Real>(lanesCross(startDirX, startDirY, qax, qay)), lanesLength(qax, qay)); // distance from A
+    param = VectorDivide(VectorNegate(lanesDot(qax, qay, startDirX, startDirY)), lanesDot(startDirX, startDirY, startDirX, startDirY));
+    {
+        Lanes endDistance = lanesLength(bqx, bqy); // distance from B
+        Lanes nearerEnd = VectorCompareLT(endDistance, VectorAbs(minDistance));
+        minDistance = VectorSelect(nearerEnd, VectorMultiply(lanesNonZeroSign<Real>(lanesCross(endDirX, endDirY, bqx, bqy)), endDistance), minDistance);
+        param = VectorSelect(nearerEnd, VectorDivide(lanesDot(VectorSubtract(endDirX, bqx), VectorSubtract(endDirY, bqy), endDirX, endDirY), lanesDot(endDirX, endDirY, endDirX, endDirY)), param);
+    }
+    if (cubicSearch == GeneratorConfig::BRACKETED_CUBIC_SEARCH)
+        cubicBracketedSearch<Real>(edges, indices, qax, qay, abx, aby, brx, bry, asx, asy, minDistance, param);
+    else {
+        // Iterative minimum distance search
+        for (int i = 0; i <= MSDFGEN_CUBIC_SEARCH_STARTS; ++i) {
+            Lanes t = broadcast<Real>(Real(1./MSDFGEN_CUBIC_SEARCH_STARTS*i));
+            Lanes qex, qey, d1x, d1y;
+            cubicOffset<Real>(t, qax, qay, abx, aby, brx, bry, asx, asy, qex, qey);
+            cubicDirection<Real>(t, abx, aby, brx, bry, asx, asy, d1x, d1y);
+            Lanes improvedT = cubicNewtonStep<Real>(t, qex, qey, d1x, d1y, brx, bry, asx, asy);
+            Lanes searching = lanesInOpenUnitInterval<Real>(improvedT);
+            if (!VectorMaskBits(searching))
+                continue;
+            Lanes refining = searching;
+            for (int step = 1; ; ++step) {
+                t = VectorSelect(refining, improvedT, t);
+                Lanes nextQex, nextQey, nextD1x, nextD1y;
+                cubicOffset<Real>(t, qax, qay, abx, aby, brx, bry, asx, asy, nextQex, nextQey);
+                cubicDirection<Real>(t, abx, aby, brx, bry, asx, asy, nextD1x, nextD1y);
+                qex = VectorSelect(refining, nextQex, qex);
+                qey = VectorSelect(refining, nextQey, qey);
+                d1x = VectorSelect(refining, nextD1x, d1x);
+                d1y = VectorSelect(refining, nextD1y, d1y);
+                if (step == MSDFGEN_CUBIC_SEARCH_STEPS)
+                    break;
+                improvedT = cubicNewtonStep<Real>(t, qex, qey, d1x, d1y, brx, bry, asx, asy);
+                refining = VectorBitwiseAnd(refining, lanesInOpenUnitInterval<Real>(improvedT));
+                if (!VectorMaskBits(refining))
+                    break;
+            }
+            Lanes searchDistance = lanesLength(qex, qey);
+            Lanes nearer = VectorBitwiseAnd(searching, VectorCompareLT(searchDistance, VectorAbs(minDistance)));
+            minDistance = VectorSelect(nearer, VectorMultiply(lanesNonZeroSign<Real>(lanesCross(d1x, d1y, qex, qey)), searchDistance), minDistance);
+            param = VectorSelect(nearer, t, param);
+        }
+    }
+
+    Lanes onEdge = VectorBitwiseAnd(VectorCompareGE(param, zero), VectorCompareLE(param, broadcast<Real>(1)));
+    Lanes nearStart = VectorCompareLT(param, broadcast<Real>(.5));
+    Lanes startDirNX, startDirNY, qaNX, qaNY, endDirNX, endDirNY, bqNX, bqNY;
+    lanesNormalize<Real>(startDirX, startDirY, startDirNX, startDirNY);
+    lanesNormalize<Real>(qax, qay, qaNX, qaNY);
+    lanesNormalize<Real>(endDirX, endDirY, endDirNX, endDirNY);
+    lanesNormalize<Real>(bqx, bqy, bqNX, bqNY);
+    Lanes endpointDot = VectorSelect(nearStart, VectorAbs(lanesDot(startDirNX, startDirNY, qaNX, qaNY)), VectorAbs(lanesDot(endDirNX, endDirNY, bqNX, bqNY)));
+    distance = minDistance;
+    dot = VectorSelect(onEdge, zero, endpointDot);
+}
+
+/// Vector2 in the precision of a compiled shape, for the edges evaluated one at a time.
+template <typename Real>
+struct PackedVector2 {
+    Real x, y;
+
+    inline PackedVector2(Real x, Real y) : x(x), y(y) { }
+    inline PackedVector2(const std::vector<Real> &xs, const std::vector<Real> &ys, int index) : x(xs[index]), y(ys[index]) { }
+    inline Real length() const {
+        return sqrt(x*x+y*y);
+    }
+    inline PackedVector2 normalize() const {
+        if (Real len = length())
+            return PackedVector2(x/len, y/len);
+        return PackedVector2(0, 1);
+    }
+    inline PackedVector2 operator+(const PackedVector2 &other) const {
+        return PackedVector2(x+other.x, y+other.y);
+    }
+    inline PackedVector2 operator-(const PackedVector2 &other) const {
+        return PackedVector2(x-other.x, y-other.y);
+    }
+    inline friend PackedVector2 operator*(Real value, const PackedVector2 &vector) {
+        return PackedVector2(value*vector.x, value*vector.y);
+    }
+    inline friend Real dotProduct(const PackedVector2 &a, const PackedVector2 &b) {
+        return a.x*b.x+a.y*b.y;
+    }
+    inline friend Real crossProduct(const PackedVector2 &a, const PackedVector2 &b) {
+        return a.x*b.y-a.y*b.x;
+    }
+};
+
+/// QuadraticSegment::signedDistance of the edge at index. The cubic equation's analytic solution branches differently for every edge, so quadratic edges are evaluated one at a time.
+template <typename Real>
+static SignedDistance quadraticSignedDistance(const Point2 &point, const typename CompiledShape<Real>::QuadraticEdges &edges, int index, double &outParam) {
+    typedef PackedVector2<Real> Vector;
+    Vector origin(Real(point.x), Real(point.y));
+    Vector qa = Vector(edges.p0.x, edges.p0.y, index)-origin;
+    Vector ab(edges.ab.x, edges.ab.y, index);
+    Vector br(edges.br.x, edges.br.y, index);
+    Vector p1(edges.p1.x, edges.p1.y, index);
+    Vector p2(edges.p2.x, edges.p2.y, index);
+    Vector startDir(edges.startDir.x, edges.startDir.y, index);
+    Vector endDir(edges.endDir.x, edges.endDir.y, index);
+    Real a = dotProduct(br, br);
+    Real b = 3*dotProduct(ab, br);
+    Real c = 2*dotProduct(ab, ab)+dotProduct(qa, br);
+    Real d = dotProduct(qa, ab);
+    Real t[3];
+    int solutions = solveCubic(t, a, b, c, d);
+
+    Real minDistance = nonZeroSign(crossProduct(startDir, qa))*qa.length(); // distance from A
+    Real param = -dotProduct(qa, startDir)/dotProduct(startDir, startDir);
+    {
+        Real distance = (p2-origin).length(); // distance from B
+        if (distance < fabs(minDistance)) {
+            minDistance = nonZeroSign(crossProduct(endDir, p2-origin))*distance;
+            param = dotProduct(origin-p1, endDir)/dotProduct(endDir, endDir);
+        }
+    }
+    for (int i = 0; i < solutions; ++i) {
+        if (t[i] > 0 && t[i] < 1) {
+            Vector qe = qa+2*t[i]*ab+t[i]*t[i]*br;
+            Real distance = qe.length();
+            if (distance <= fabs(minDistance)) {
+                minDistance = nonZeroSign(crossProduct(ab+t[i]*br, qe))*distance;
+                param = t[i];
+            }
+        }
+    }
+
+    outParam = param;
+    if (param >= 0 && param <= 1)
+        return SignedDistance(minDistance, 0);
+    if (param < Real(.5))
+        return SignedDistance(minDistance, fabs(dotProduct(startDir.normalize(), qa.normalize())));
+    else
+        return SignedDistance(minDistance, fabs(dotProduct(endDir.normalize(), (p2-origin).normalize())));
+}
+
+CompiledShapeBase::CompiledShapeBase(const Shape &shape) : inverseYAxis(shape.inverseYAxis) {
+    int edgeCount = shape.edgeCount();
+    edges.reserve(edgeCount);
+    edgeRefs.reserve(edgeCount);
+    contourEdges.reserve(shape.contours.size()+1);
+    contourWindings.reserve(shape.contours.size());
+    int typeCounts[CubicSegment::EDGE_TYPE+1] = { };
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
+        contourEdges.push_back((int) edges.size());
+        contourWindings.push_back(contour->winding());
+        int contourEdgeCount = (int) contour->edges.size();
+        for (int k = 0; k < contourEdgeCount; ++k) {
+            const EdgeSegment *prevEdge = contour->edges[(k+2*contourEdgeCount-2)%contourEdgeCount];
+            const EdgeSegment *edge = contour->edges[(k+contourEdgeCount-1)%contourEdgeCount];
+            const EdgeSegment *nextEdge = contour->edges[k];
+            edges.push_back(PreparedEdge(prevEdge, edge, nextEdge));
+            EdgeRef ref;
+            ref.type = edge->type();
+            ref.index = typeCounts[ref.type]++;
+            edgeRefs.push_back(ref);
+        }
+    }
+    contourEdges.push_back((int) edges.size());
+}
+
+int CompiledShapeBase::contourCount() const {
+    return (int) contourWindings.size();
+}
+
+template <typename Real>
+void CompiledShape<Real>::PackedPoints::add(const Vector2 &point) {
+    x.push_back(Real(point.x));
+    y.push_back(Real(point.y));
+}
+
+/// Fills bounds with the parameters bounding the sections of a cubic edge for BRACKETED_CUBIC_SEARCH, and returns the number of sections.
+static int cubicSectionBounds(const Point2 p[4], double bounds[CompiledShape<double>::CUBIC_SECTION_BOUNDS_CAPACITY]) {
+    // Besides even intervals, the sections are split where the derivative of either coordinate, 3*(ab+2*t*br+t*t*as), is zero, so that no section's direction turns by more than 90 degrees
+    Vector2 ab = p[1]-p[0];
+    Vector2 br = p[2]-p[1]-ab;
+    Vector2 as = (p[3]-p[2])-(p[2]-p[1])-br;
+    double splits[MSDFGEN_CUBIC_SEARCH_STARTS+4];
+    int splitCount = 0;
+    for (int i = 1; i < MSDFGEN_CUBIC_SEARCH_STARTS; ++i)
+        splits[splitCount++] = 1./MSDFGEN_CUBIC_SEARCH_STARTS*i;
+    double roots[2];
+    int rootCount = solveQuadratic(roots, as.x, 2*br.x, ab.x);
+    for (int i = 0; i < rootCount; ++i)
+        if (roots[i] > 0 && roots[i] < 1)
+            splits[splitCount++] = roots[i];
+    rootCount = solveQuadratic(roots, as.y, 2*br.y, ab.y);
+    for (int i = 0; i < rootCount; ++i)
+        if (roots[i] > 0 && roots[i] < 1)
+            splits[splitCount++] = roots[i];
+    std::sort(splits, splits+splitCount);
+
+    int sectionCount = 0;
+    bounds[0] = 0;
+    for (int i = 0; i < splitCount; ++i)
+        if (splits[i] > bounds[sectionCount])
+            bounds[++sectionCount] = splits[i];
+    bounds[++sectionCount] = 1;
+    for (int i = sectionCount+1; i < CompiledShape<double>::CUBIC_SECTION_BOUNDS_CAPACITY; ++i)
+        bounds[i] = 1;
+    return sectionCount;
+}
+
+template <typename Real>
+CompiledShape<Real>::CompiledShape(const Shape &shape, GeneratorConfig::CubicSearch cubicSearch) : CompiledShapeBase(shape), cubicSearch(cubicSearch) {
+    // Edges are packed in the order they were assigned their indices
+    for (std::vector<PreparedEdge>::const_iterator preparedEdge = edges.begin(); preparedEdge != edges.end(); ++preparedEdge) {
+        const EdgeSegment *edge = preparedEdge->segment;
+        const Point2 *p = edge->controlPoints();
+        switch (edge->type()) {
+            case LinearSegment::EDGE_TYPE:
+                linearEdges.p0.add(p[0]);
+                linearEdges.p1.add(p[1]);
+                break;
+            case QuadraticSegment::EDGE_TYPE:
+                quadraticEdges.p0.add(p[0]);
+                quadraticEdges.p1.add(p[1]);
+                quadraticEdges.p2.add(p[2]);
+                quadraticEdges.ab.add(p[1]-p[0]);
+                quadraticEdges.br.add(p[2]-p[1]-(p[1]-p[0]));
+                quadraticEdges.startDir.add(edge->direction(0));
+                quadraticEdges.endDir.add(edge->direction(1));
+                break;
+            case CubicSegment::EDGE_TYPE:
+                cubicEdges.p0.add(p[0]);
+                cubicEdges.p3.add(p[3]);
+                cubicEdges.ab.add(p[1]-p[0]);
+                cubicEdges.br.add(p[2]-p[1]-(p[1]-p[0]));
+                cubicEdges.as.add((p[3]-p[2])-(p[2]-p[1])-(p[2]-p[1]-(p[1]-p[0])));
+                cubicEdges.startDir.add(edge->direction(0));
+                cubicEdges.endDir.add(edge->direction(1));
+                if (cubicSearch == GeneratorConfig::BRACKETED_CUBIC_SEARCH) {
+                    double bounds[CUBIC_SECTION_BOUNDS_CAPACITY];
+                    cubicEdges.sectionCounts.push_back(cubicSectionBounds(p, bounds));
+                    for (int i = 0; i < CUBIC_SECTION_BOUNDS_CAPACITY; ++i)
+                        cubicEdges.sectionBounds.push_back(Real(bounds[i]));
+                }
+                break;
+        }
+    }
+}
+
+template <typename Real>
+void CompiledShape<Real>::signedDistances(const Point2 &origin, const int *edgeIndices, int count, SignedDistance *distances, double *params) const {
+    typedef typename LaneTraits<Real>::Lanes Lanes;
+    Lanes qx = broadcast(Real(origin.x)), qy = broadcast(Real(origin.y));
+    Lanes distance, dot, param;
+    // Edges of each type are collected until there are enough to fill the lanes. The slots record where each lane's result goes
+    int linearIndices[BATCH_SIZE], linearSlots[BATCH_SIZE], linearCount = 0;
+    int cubicIndices[BATCH_SIZE], cubicSlots[BATCH_SIZE], cubicCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const EdgeRef &ref = edgeRefs[edgeIndices[i]];
+        switch (ref.type) {
+            case LinearSegment::EDGE_TYPE:
+                linearIndices[linearCount] = ref.index;
+                linearSlots[linearCount] = i;
+                if (++linearCount == BATCH_SIZE) {
+                    linearSignedDistance<Real>(qx, qy, linearEdges, linearIndices, distance, dot, param);
+                    storeSignedDistances<Real>(distance, dot, param, linearSlots, linearCount, distances, params);
+                    linearCount = 0;
+                }
+                break;
+            case QuadraticSegment::EDGE_TYPE:
+                distances[i] = quadraticSignedDistance<Real>(origin, quadraticEdges, ref.index, params[i]);
+                break;
+            case CubicSegment::EDGE_TYPE:
+                cubicIndices[cubicCount] = ref.index;
+                cubicSlots[cubicCount] = i;
+                if (++cubicCount == BATCH_SIZE) {
+                    cubicSignedDistance<Real>(qx, qy, cubicEdges, cubicSearch, cubicIndices, distance, dot, param);
+                    storeSignedDistances<Real>(distance, dot, param, cubicSlots, cubicCount, distances, params);
+                    cubicCount = 0;
+                }
+                break;
+        }
+    }
+    // Unused lanes of the remaining partial batches repeat their first edge, and their results are discarded
+    if (linearCount) {
+        for (int i = linearCount; i < BATCH_SIZE; ++i)
+            linearIndices[i] = linearIndices[0];
+        linearSignedDistance<Real>(qx, qy, linearEdges, linearIndices, distance, dot, param);
+        storeSignedDistances<Real>(distance, dot, param, linearSlots, linearCount, distances, params);
+    }
+    if (cubicCount) {
+        for (int i = cubicCount; i < BATCH_SIZE; ++i)
+            cubicIndices[i] = cubicIndices[0];
+        cubicSignedDistance<Real>(qx, qy, cubicEdges, cubicSearch, cubicIndices, distance, dot, param);
+        storeSignedDistances<Real>(distance, dot, param, cubicSlots, cubicCount, distances, params);
+    }
+}
+
+template <typename Real>
+void CompiledShape<Real>::signedDistances(const Point2 origins[BATCH_SIZE], int edgeIndex, SignedDistance distances[BATCH_SIZE], double params[BATCH_SIZE]) const {
+    typedef typename LaneTraits<Real>::Lanes Lanes;
+    static const int slots[BATCH_SIZE] = { 0, 1, 2, 3 };
+    const EdgeRef &ref = edgeRefs[edgeIndex];
+    int indices[BATCH_SIZE] = { ref.index, ref.index, ref.index, ref.index };
+    Lanes qx = LaneTraits<Real>::set(Real(origins[0].x), Real(origins[1].x), Real(origins[2].x), Real(origins[3].x));
+    Lanes qy = LaneTraits<Real>::set(Real(origins[0].y), Real(origins[1].y), Real(origins[2].y), Real(origins[3].y));
+    Lanes distance, dot, param;
+    switch (ref.type) {
+        case LinearSegment::EDGE_TYPE:
+            linearSignedDistance<Real>(qx, qy, linearEdges, indices, distance, dot, param);
+            storeSignedDistances<Real>(distance, dot, param, slots, BATCH_SIZE, distances, params);
+            break;
+        case QuadraticSegment::EDGE_TYPE:
+            for (int i = 0; i < BATCH_SIZE; ++i)
+                distances[i] = quadraticSignedDistance<Real>(origins[i], quadraticEdges, ref.index, params[i]);
+            break;
+        case CubicSegment::EDGE_TYPE:
+            cubicSignedDistance<Real>(qx, qy, cubicEdges, cubicSearch, indices, distance, dot, param);
+            storeSignedDistances<Real>(distance, dot, param, slots, BATCH_SIZE, distances, params);
+            break;
+    }
+}
+
+template class CompiledShape<double>;
+template class CompiledShape<float>;
+
+}
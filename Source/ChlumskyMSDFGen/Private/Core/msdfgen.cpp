@@ -2,10 +2,17 @@
 #include "msdfgen.h"
 
 #include <vector>
+#include <unordered_map>
 #include "edge-selectors.h"
 #include "contour-combiners.h"
 #include "msdf-error-correction.h"
 #include "ShapeDistanceFinder.h"
+#include "ShapeEdgeIndex.h"
+#include "CompiledShape.h"
+#include "CompiledShapeDistanceFinder.h"
+#include "arithmetics.hpp"
+#include "row-bands.h"
+#include "Async/ParallelFor.h"
 
 namespace msdfgen {
 
@@ -50,88 +57,192 @@ public:
     }
 };
 
+int rowBandCount(int height, int threadCount) {
+    if (threadCount <= 0)
+        threadCount = MSDFGEN_ROW_BANDS_PER_THREAD*(FTaskGraphInterface::Get().GetNumWorkerThreads()+1);
+    return max(1, min(height, threadCount));
+}
+
+typedef std::unordered_map<const EdgeSegment *, int> EdgeIndexMap;
+
+/// Indexes the edges contour by contour, as expected by msdfErrorCorrection's nearestEdges.
+static void buildEdgeIndexMap(const Shape &shape, EdgeIndexMap &edgeIndices) {
+    edgeIndices.reserve(shape.edgeCount());
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour)
+        for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge)
+            edgeIndices.insert(std::make_pair((const EdgeSegment *) *edge, (int) edgeIndices.size()));
+}
+
+static void buildEdgeIndexMap(const CompiledShapeBase &shape, EdgeIndexMap &edgeIndices) {
+    edgeIndices.reserve(shape.edges.size());
+    for (int contourIndex = 0; contourIndex < shape.contourCount(); ++contourIndex) {
+        int contourBegin = shape.contourEdges[contourIndex];
+        int contourEdgeCount = shape.contourEdges[contourIndex+1]-contourBegin;
+        // Position k of a compiled contour holds the contour's edge k-1
+        for (int k = 0; k < contourEdgeCount; ++k)
+            edgeIndices.insert(std::make_pair(shape.edges[contourBegin+k].segment, contourBegin+(k+contourEdgeCount-1)%contourEdgeCount));
+    }
+}
+
+/// Only the multi-channel selectors track a nearest edge per channel.
+template <class EdgeSelector>
+static void recordNearestEdges(int *, const EdgeSelector &, const EdgeIndexMap &) { }
+
+static void recordNearestEdges(int *texelEdges, const MultiDistanceSelector &edgeSelector, const EdgeIndexMap &edgeIndices) {
+    const EdgeSegment *edges[3];
+    edgeSelector.nearestEdges(edges);
+    for (int i = 0; i < 3; ++i) {
+        EdgeIndexMap::const_iterator edgeIndex = edges[i] ? edgeIndices.find(edges[i]) : edgeIndices.end();
+        texelEdges[i] = edgeIndex != edgeIndices.end() ? edgeIndex->second : -1;
+    }
+}
+
+static void recordNearestEdges(int *texelEdges, const MultiAndTrueDistanceSelector &edgeSelector, const EdgeIndexMap &edgeIndices) {
+    recordNearestEdges(texelEdges, static_cast<const MultiDistanceSelector &>(edgeSelector), edgeIndices);
+}
+
+template <class ContourCombiner, typename Real>
+void generateDistanceField(const typename DistancePixelConversion<typename ContourCombiner::DistanceType>::BitmapRefType &output, const CompiledShape<Real> &shape, const SDFTransformation &transformation, const GeneratorConfig &config, const ShapeEdgeIndex *edgeIndex = NULL, const BitmapRef<int, 3> &nearestEdges = BitmapRef<int, 3>()) {
+    typedef CompiledShapeDistanceFinder<ContourCombiner, Real> DistanceFinder;
+    DistancePixelConversion<typename ContourCombiner::DistanceType> distancePixelConversion(transformation.distanceMapping);
+    EdgeIndexMap edgeIndices;
+    if (nearestEdges.pixels)
+        buildEdgeIndexMap(shape, edgeIndices);
+    int bandCount = rowBandCount(output.height, config.threadCount);
+    ParallelFor(bandCount, [&](int band) {
+        DistanceFinder distanceFinder(shape, edgeIndex);
+        int bandStart = int((int64) output.height*band/bandCount);
+        int bandEnd = int((int64) output.height*(band+1)/bandCount);
+        for (int y = bandStart; y < bandEnd; ++y) {
+            int row = shape.inverseYAxis ? output.height-y-1 : y;
+            // Serpentine direction is derived from the row rather than the band, so every row is traversed in the same order as a single-threaded pass
+            bool rightToLeft = (y&1) != 0;
+            int col = 0;
+            // Runs of adjacent pixels are evaluated together, with the remainder of the row evaluated one by one
+            for (; col+DistanceFinder::BATCH_SIZE <= output.width; col += DistanceFinder::BATCH_SIZE) {
+                int xs[DistanceFinder::BATCH_SIZE];
+                Point2 origins[DistanceFinder::BATCH_SIZE];
+                for (int i = 0; i < DistanceFinder::BATCH_SIZE; ++i) {
+                    xs[i] = rightToLeft ? output.width-(col+i)-1 : col+i;
+                    origins[i] = transformation.unproject(Point2(xs[i]+.5, y+.5));
+                }
+                typename ContourCombiner::DistanceType distances[DistanceFinder::BATCH_SIZE];
+                distanceFinder.distances(origins, distances);
+                for (int i = 0; i < DistanceFinder::BATCH_SIZE; ++i) {
+                    distancePixelConversion(output(xs[i], row), distances[i]);
+                    if (nearestEdges.pixels)
+                        recordNearestEdges(nearestEdges(xs[i], row), distanceFinder.getContourCombiner(i).mergedEdgeSelector(), edgeIndices);
+                }
+            }
+            for (; col < output.width; ++col) {
+                int x = rightToLeft ? output.width-col-1 : col;
+                Point2 p = transformation.unproject(Point2(x+.5, y+.5));
+                typename ContourCombiner::DistanceType distance = distanceFinder.distance(p);
+                distancePixelConversion(output(x, row), distance);
+                if (nearestEdges.pixels)
+                    recordNearestEdges(nearestEdges(x, row), distanceFinder.getContourCombiner().mergedEdgeSelector(), edgeIndices);
+            }
+        }
+    }, bandCount == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
 template <class ContourCombiner>
-void generateDistanceField(const typename DistancePixelConversion<typename ContourCombiner::DistanceType>::BitmapRefType &output, const Shape &shape, const SDFTransformation &transformation) {
+void generateDistanceField(const typename DistancePixelConversion<typename ContourCombiner::DistanceType>::BitmapRefType &output, const Shape &shape, const SDFTransformation &transformation, const GeneratorConfig &config, const ShapeEdgeIndex *edgeIndex = NULL, const BitmapRef<int, 3> &nearestEdges = BitmapRef<int, 3>()) {
+    if (config.useCompiledShape) {
+        if (config.singlePrecision) {
+            CompiledShape<float> compiledShape(shape, config.cubicSearch);
+            generateDistanceField<ContourCombiner>(output, compiledShape, transformation, config, edgeIndex, nearestEdges);
+        } else {
+            CompiledShape<double> compiledShape(shape, config.cubicSearch);
+            generateDistanceField<ContourCombiner>(output, compiledShape, transformation, config, edgeIndex, nearestEdges);
+        }
+        return;
+    }
     DistancePixelConversion<typename ContourCombiner::DistanceType> distancePixelConversion(transformation.distanceMapping);
-#ifdef MSDFGEN_USE_OPENMP
-    #pragma omp parallel
-#endif
-    {
-        ShapeDistanceFinder<ContourCombiner> distanceFinder(shape);
-        bool rightToLeft = false;
-#ifdef MSDFGEN_USE_OPENMP
-        #pragma omp for
-#endif
-        for (int y = 0; y < output.height; ++y) {
+    EdgeIndexMap edgeIndices;
+    if (nearestEdges.pixels)
+        buildEdgeIndexMap(shape, edgeIndices);
+    int bandCount = rowBandCount(output.height, config.threadCount);
+    ParallelFor(bandCount, [&](int band) {
+        ShapeDistanceFinder<ContourCombiner> distanceFinder(shape, edgeIndex);
+        int bandStart = int((int64) output.height*band/bandCount);
+        int bandEnd = int((int64) output.height*(band+1)/bandCount);
+        for (int y = bandStart; y < bandEnd; ++y) {
             int row = shape.inverseYAxis ? output.height-y-1 : y;
+            // Serpentine direction is derived from the row rather than the band, so every row is traversed in the same order as a single-threaded pass
+            bool rightToLeft = (y&1) != 0;
             for (int col = 0; col < output.width; ++col) {
                 int x = rightToLeft ? output.width-col-1 : col;
                 Point2 p = transformation.unproject(Point2(x+.5, y+.5));
                 typename ContourCombiner::DistanceType distance = distanceFinder.distance(p);
                 distancePixelConversion(output(x, row), distance);
+                if (nearestEdges.pixels)
+                    recordNearestEdges(nearestEdges(x, row), distanceFinder.getContourCombiner().mergedEdgeSelector(), edgeIndices);
             }
-            rightToLeft = !rightToLeft;
         }
-    }
+    }, bandCount == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
 }
+
 void generateSDF(const BitmapRef<float, 1> &output, const Shape &shape, const SDFTransformation &transformation, const GeneratorConfig &config) {
+    // Only the true distance selector can skip edges by their bounds, so the index is not built for the perpendicular distance variants
+    ShapeEdgeIndex *edgeIndex = config.useEdgeIndex ? new ShapeEdgeIndex(shape) : NULL;
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<TrueDistanceSelector> >(output, shape, transformation);
+        generateDistanceField<OverlappingContourCombiner<TrueDistanceSelector> >(output, shape, transformation, config, edgeIndex);
     else
-        generateDistanceField<SimpleContourCombiner<TrueDistanceSelector> >(output, shape, transformation);
+        generateDistanceField<SimpleContourCombiner<TrueDistanceSelector> >(output, shape, transformation, config, edgeIndex);
+    delete edgeIndex;
 }
 
 void generatePSDF(const BitmapRef<float, 1> &output, const Shape &shape, const SDFTransformation &transformation, const GeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<PerpendicularDistanceSelector> >(output, shape, transformation);
+        generateDistanceField<OverlappingContourCombiner<PerpendicularDistanceSelector> >(output, shape, transformation, config);
     else
-        generateDistanceField<SimpleContourCombiner<PerpendicularDistanceSelector> >(output, shape, transformation);
+        generateDistanceField<SimpleContourCombiner<PerpendicularDistanceSelector> >(output, shape, transformation, config);
 }
 
-void generateMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const SDFTransformation &transformation, const MSDFGeneratorConfig &config) {
+/// Generates a multi-channel distance field and corrects its errors, recording the nearest edges for the error correction's distance checks if they are configured to use them.
+template <class EdgeSelector, int N>
+static void generateMultiChannelDistanceField(const BitmapRef<float, N> &output, const Shape &shape, const SDFTransformation &transformation, const MSDFGeneratorConfig &config) {
+    const ErrorCorrectionConfig &errorCorrection = config.errorCorrection;
+    std::vector<int> nearestEdgeBuffer;
+    if (errorCorrection.useNearestEdges && errorCorrection.mode != ErrorCorrectionConfig::DISABLED && errorCorrection.distanceCheckMode != ErrorCorrectionConfig::DO_NOT_CHECK_DISTANCE)
+        nearestEdgeBuffer.resize(3*output.width*output.height);
+    BitmapRef<int, 3> nearestEdges(nearestEdgeBuffer.empty() ? NULL : &nearestEdgeBuffer[0], output.width, output.height);
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<MultiDistanceSelector> >(output, shape, transformation);
+        generateDistanceField<OverlappingContourCombiner<EdgeSelector> >(output, shape, transformation, config, NULL, nearestEdges);
     else
-        generateDistanceField<SimpleContourCombiner<MultiDistanceSelector> >(output, shape, transformation);
-    msdfErrorCorrection(output, shape, transformation, config);
+        generateDistanceField<SimpleContourCombiner<EdgeSelector> >(output, shape, transformation, config, NULL, nearestEdges);
+    if (nearestEdges.pixels)
+        msdfErrorCorrection(output, shape, transformation, config, nearestEdges);
+    else
+        msdfErrorCorrection(output, shape, transformation, config);
+}
+
+void generateMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const SDFTransformation &transformation, const MSDFGeneratorConfig &config) {
+    generateMultiChannelDistanceField<MultiDistanceSelector>(output, shape, transformation, config);
 }
 
 void generateMTSDF(const BitmapRef<float, 4> &output, const Shape &shape, const SDFTransformation &transformation, const MSDFGeneratorConfig &config) {
-    if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, transformation);
-    else
-        generateDistanceField<SimpleContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, transformation);
-    msdfErrorCorrection(output, shape, transformation, config);
+    generateMultiChannelDistanceField<MultiAndTrueDistanceSelector>(output, shape, transformation, config);
 }
 
 void generateSDF(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, Range range, const GeneratorConfig &config) {
-    if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<TrueDistanceSelector> >(output, shape, SDFTransformation(projection, range));
-    else
-        generateDistanceField<SimpleContourCombiner<TrueDistanceSelector> >(output, shape, SDFTransformation(projection, range));
+    generateSDF(output, shape, SDFTransformation(projection, range), config);
 }
 
 void generatePSDF(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, Range range, const GeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<PerpendicularDistanceSelector> >(output, shape, SDFTransformation(projection, range));
+        generateDistanceField<OverlappingContourCombiner<PerpendicularDistanceSelector> >(output, shape, SDFTransformation(projection, range), config);
     else
-        generateDistanceField<SimpleContourCombiner<PerpendicularDistanceSelector> >(output, shape, SDFTransformation(projection, range));
+        generateDistanceField<SimpleContourCombiner<PerpendicularDistanceSelector> >(output, shape, SDFTransformation(projection, range), config);
 }
 
 void generateMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, Range range, const MSDFGeneratorConfig &config) {
-    if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<MultiDistanceSelector> >(output, shape, SDFTransformation(projection, range));
-    else
-        generateDistanceField<SimpleContourCombiner<MultiDistanceSelector> >(output, shape, SDFTransformation(projection, range));
-    msdfErrorCorrection(output, shape, SDFTransformation(projection, range), config);
+    generateMultiChannelDistanceField<MultiDistanceSelector>(output, shape, SDFTransformation(projection, range), config);
 }
 
 void generateMTSDF(const BitmapRef<float, 4> &output, const Shape &shape, const Projection &projection, Range range, const MSDFGeneratorConfig &config) {
-    if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, SDFTransformation(projection, range));
-    else
-        generateDistanceField<SimpleContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, SDFTransformation(projection, range));
-    msdfErrorCorrection(output, shape, SDFTransformation(projection, range), config);
+    generateMultiChannelDistanceField<MultiAndTrueDistanceSelector>(output, shape, SDFTransformation(projection, range), config);
 }
 
 // Legacy API
@@ -0,0 +1,12 @@
+
+#pragma once
+
+// Number of row bands handed out per available thread when no explicit thread count is configured. More bands balance uneven shapes better, fewer bands keep the distance finder caches warm for longer
+#define MSDFGEN_ROW_BANDS_PER_THREAD 4
+
+namespace msdfgen {
+
+/// Returns the number of contiguous row bands an output of the given height is split into for threadCount (see GeneratorConfig). Each band is processed by a single worker.
+int rowBandCount(int height, int threadCount);
+
+}
@@ -0,0 +1,102 @@
+
+#pragma once
+
+#include <vector>
+#include "Vector2.hpp"
+#include "SignedDistance.hpp"
+#include "Shape.h"
+#include "edge-selectors.h"
+#include "generator-config.h"
+
+namespace msdfgen {
+
+/// Edges and contours of a CompiledShape, which do not depend on the precision its distances are evaluated in.
+class CompiledShapeBase {
+
+public:
+    enum {
+        /// Number of edges or points whose distances are evaluated together.
+        BATCH_SIZE = 4
+    };
+
+    /// Locates an edge in the packed array of its segment type.
+    struct EdgeRef {
+        int type;
+        int index;
+    };
+
+    /// Edges of all contours, for the edge selectors. Position k of a contour holds the edge preceding its k-th edge, matching the order in which ShapeDistanceFinder visits them and the positions of ShapeEdgeIndex.
+    std::vector<PreparedEdge> edges;
+    /// Location of each edge of edges in the packed arrays.
+    std::vector<EdgeRef> edgeRefs;
+    /// Index of each contour's first edge. Contour i's edges span [contourEdges[i], contourEdges[i+1]).
+    std::vector<int> contourEdges;
+    /// Winding of each contour, for OverlappingContourCombiner.
+    std::vector<int> contourWindings;
+    bool inverseYAxis;
+
+    /// Returns the number of contours.
+    int contourCount() const;
+
+protected:
+    explicit CompiledShapeBase(const Shape &shape);
+
+};
+
+/// Flattened copy of a Shape for faster distance queries. Edges are stored without virtual dispatch, in separate packed arrays for each segment type,
+/// and their distances are evaluated in batches, with SIMD across several edges for one point or across several points for one edge.
+/// Real is the precision that distances are evaluated in. Single precision fits twice as many values per register, and is accurate enough for 8 bit outputs.
+template <typename Real>
+class CompiledShape : public CompiledShapeBase {
+
+public:
+    enum {
+        /// Capacity of the section bounds of a cubic edge for BRACKETED_CUBIC_SEARCH. A curve is split into MSDFGEN_CUBIC_SEARCH_STARTS even intervals, and again at up to two extrema of each coordinate.
+        CUBIC_SECTION_BOUNDS_CAPACITY = MSDFGEN_CUBIC_SEARCH_STARTS+5
+    };
+
+    /// Coordinates of one control point (or derived vector) of every edge of a segment type.
+    struct PackedPoints {
+        std::vector<Real> x, y;
+
+        void add(const Vector2 &point);
+    };
+
+    struct LinearEdges {
+        PackedPoints p0, p1;
+    };
+
+    struct QuadraticEdges {
+        /// Control points, and the polynomial terms ab = p1-p0 and br = p2-p1-ab.
+        PackedPoints p0, p1, p2, ab, br;
+        /// Unnormalized directions at the start and end points.
+        PackedPoints startDir, endDir;
+    };
+
+    struct CubicEdges {
+        /// End points, and the polynomial terms ab = p1-p0, br = p2-p1-ab and as = (p3-p2)-(p2-p1)-br.
+        PackedPoints p0, p3, ab, br, as;
+        /// Unnormalized directions at the start and end points.
+        PackedPoints startDir, endDir;
+        /// For BRACKETED_CUBIC_SEARCH, the parameters bounding the sections of each edge, CUBIC_SECTION_BOUNDS_CAPACITY per edge with the unused ones set to 1, and the number of sections of each edge.
+        std::vector<Real> sectionBounds;
+        std::vector<int> sectionCounts;
+    };
+
+    // The source shape's edges are referenced by the prepared edges, so it must not be modified or destroyed until the compiled shape is destroyed!
+    explicit CompiledShape(const Shape &shape, GeneratorConfig::CubicSearch cubicSearch = GeneratorConfig::UNIFORM_CUBIC_SEARCH);
+
+    LinearEdges linearEdges;
+    QuadraticEdges quadraticEdges;
+    CubicEdges cubicEdges;
+    /// Algorithm used to find the closest points of cubic edges.
+    GeneratorConfig::CubicSearch cubicSearch;
+
+    /// Evaluates the signed distances between origin and each of the count edges listed in edgeIndices, equivalent to EdgeSegment::signedDistance.
+    void signedDistances(const Point2 &origin, const int *edgeIndices, int count, SignedDistance *distances, double *params) const;
+    /// Evaluates the signed distances between each of BATCH_SIZE origins and a single edge, equivalent to EdgeSegment::signedDistance.
+    void signedDistances(const Point2 origins[BATCH_SIZE], int edgeIndex, SignedDistance distances[BATCH_SIZE], double params[BATCH_SIZE]) const;
+
+};
+
+}
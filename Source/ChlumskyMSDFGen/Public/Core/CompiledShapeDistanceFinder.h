@@ -0,0 +1,53 @@
+
+#pragma once
+
+#include <vector>
+#include "Vector2.hpp"
+#include "edge-selectors.h"
+#include "contour-combiners.h"
+#include "CompiledShape.h"
+#include "ShapeEdgeIndex.h"
+
+namespace msdfgen {
+
+/// Finds the distance between points and a CompiledShape. ContourCombiner dictates the distance metric and its data type.
+/// Selects the same edges as ShapeDistanceFinder, but evaluates their distances in batches, in the precision given by Real.
+template <class ContourCombiner, typename Real = double>
+class CompiledShapeDistanceFinder {
+
+public:
+    typedef typename ContourCombiner::DistanceType DistanceType;
+
+    enum {
+        BATCH_SIZE = CompiledShapeBase::BATCH_SIZE
+    };
+
+    // Passed compiled shape (and edge index of its source shape, if any) must persist until the distance finder is destroyed!
+    explicit CompiledShapeDistanceFinder(const CompiledShape<Real> &shape, const ShapeEdgeIndex *edgeIndex = NULL);
+    /// Finds the distance from origin, evaluating the possibly relevant edges of each contour together. Not thread-safe! Is fastest when subsequent queries are close together.
+    DistanceType distance(const Point2 &origin);
+    /// Finds the distances from BATCH_SIZE origins, evaluating each edge for all origins that it may be relevant to together. Not thread-safe! Is fastest when the origins are close together, as are subsequent queries.
+    void distances(const Point2 origins[BATCH_SIZE], DistanceType distances[BATCH_SIZE]);
+    /// Returns the contour combiner of one of the origins of the last query, which holds the edges selected for it. The last distance query is origin 0.
+    const ContourCombiner &getContourCombiner(int origin = 0) const;
+
+private:
+    typedef typename ContourCombiner::EdgeSelectorType EdgeSelectorType;
+    typedef typename EdgeSelectorType::EdgeCache EdgeCache;
+
+    const CompiledShape<Real> &shape;
+    const ShapeEdgeIndex *edgeIndex;
+    /// One contour combiner per origin of a batch.
+    std::vector<ContourCombiner> contourCombiners;
+    /// BATCH_SIZE consecutive caches per edge, one per origin of a batch.
+    std::vector<EdgeCache> shapeEdgeCache;
+    /// Scratch space for the possibly relevant edges of a contour and their distances.
+    std::vector<int> relevantEdges;
+    std::vector<SignedDistance> edgeDistances;
+    std::vector<double> edgeParams;
+
+};
+
+}
+
+#include "CompiledShapeDistanceFinder.hpp"
@@ -0,0 +1,126 @@
+
+#include "CompiledShapeDistanceFinder.h"
+
+namespace msdfgen {
+
+template <class ContourCombiner, typename Real>
+CompiledShapeDistanceFinder<ContourCombiner, Real>::CompiledShapeDistanceFinder(const CompiledShape<Real> &shape, const ShapeEdgeIndex *edgeIndex) : shape(shape), edgeIndex(edgeIndex), shapeEdgeCache(BATCH_SIZE*shape.edges.size()), relevantEdges(shape.edges.size()), edgeDistances(shape.edges.size()), edgeParams(shape.edges.size()) {
+    contourCombiners.reserve(BATCH_SIZE);
+    for (int i = 0; i < BATCH_SIZE; ++i)
+        contourCombiners.push_back(ContourCombiner(shape));
+}
+
+template <class ContourCombiner, typename Real>
+typename CompiledShapeDistanceFinder<ContourCombiner, Real>::DistanceType CompiledShapeDistanceFinder<ContourCombiner, Real>::distance(const Point2 &origin) {
+    ContourCombiner &contourCombiner = contourCombiners[0];
+    contourCombiner.reset(origin);
+
+    for (int contourIndex = 0; contourIndex < shape.contourCount(); ++contourIndex) {
+        int contourBegin = shape.contourEdges[contourIndex];
+        int contourEnd = shape.contourEdges[contourIndex+1];
+        if (contourBegin == contourEnd)
+            continue;
+        EdgeSelectorType &edgeSelector = contourCombiner.edgeSelector(contourIndex);
+
+        // Edges are only ruled out against the selector's state before any of the contour's edges are added. This may keep a few more edges than adding them one by one would, but those cannot change the result
+        int relevantCount = 0;
+        if (edgeIndex) {
+            int nodeEnd = edgeIndex->contourNodes[contourIndex+1];
+            for (int nodeIndex = edgeIndex->contourNodes[contourIndex]; nodeIndex < nodeEnd;) {
+                const ShapeEdgeIndex::Node &node = edgeIndex->nodes[nodeIndex];
+                if (!edgeSelector.isEdgeDistanceRelevant(ShapeEdgeIndex::boundsDistance(node.bounds, origin))) {
+                    nodeIndex = node.next;
+                    continue;
+                }
+                if (node.next == nodeIndex+1) {
+                    for (int edge = contourBegin+node.begin; edge < contourBegin+node.end; ++edge) {
+                        if (edgeSelector.isEdgeRelevant(shapeEdgeCache[BATCH_SIZE*edge], shape.edges[edge]))
+                            relevantEdges[relevantCount++] = edge;
+                    }
+                }
+                ++nodeIndex;
+            }
+        } else {
+            for (int edge = contourBegin; edge < contourEnd; ++edge) {
+                if (edgeSelector.isEdgeRelevant(shapeEdgeCache[BATCH_SIZE*edge], shape.edges[edge]))
+                    relevantEdges[relevantCount++] = edge;
+            }
+        }
+        if (!relevantCount)
+            continue;
+
+        shape.signedDistances(origin, &relevantEdges[0], relevantCount, &edgeDistances[0], &edgeParams[0]);
+        for (int i = 0; i < relevantCount; ++i) {
+            int edge = relevantEdges[i];
+            edgeSelector.addEdge(shapeEdgeCache[BATCH_SIZE*edge], shape.edges[edge], edgeDistances[i], edgeParams[i]);
+        }
+    }
+
+    return contourCombiner.distance();
+}
+
+template <class ContourCombiner, typename Real>
+void CompiledShapeDistanceFinder<ContourCombiner, Real>::distances(const Point2 origins[BATCH_SIZE], DistanceType distances[BATCH_SIZE]) {
+    for (int i = 0; i < BATCH_SIZE; ++i)
+        contourCombiners[i].reset(origins[i]);
+
+    for (int contourIndex = 0; contourIndex < shape.contourCount(); ++contourIndex) {
+        int contourBegin = shape.contourEdges[contourIndex];
+        int contourEnd = shape.contourEdges[contourIndex+1];
+        if (contourBegin == contourEnd)
+            continue;
+        EdgeSelectorType *edgeSelectors[BATCH_SIZE];
+        for (int i = 0; i < BATCH_SIZE; ++i)
+            edgeSelectors[i] = &contourCombiners[i].edgeSelector(contourIndex);
+
+        // Edges are added one by one in the same order as ShapeDistanceFinder, so each origin selects exactly the edges it would on its own
+        int nodeIndex = edgeIndex ? edgeIndex->contourNodes[contourIndex] : 0;
+        int nodeEnd = edgeIndex ? edgeIndex->contourNodes[contourIndex+1] : 1;
+        while (nodeIndex < nodeEnd) {
+            int rangeBegin = contourBegin, rangeEnd = contourEnd;
+            if (edgeIndex) {
+                const ShapeEdgeIndex::Node &node = edgeIndex->nodes[nodeIndex];
+                bool nodeRelevant = false;
+                for (int i = 0; i < BATCH_SIZE && !nodeRelevant; ++i)
+                    nodeRelevant = edgeSelectors[i]->isEdgeDistanceRelevant(ShapeEdgeIndex::boundsDistance(node.bounds, origins[i]));
+                if (!nodeRelevant) {
+                    nodeIndex = node.next;
+                    continue;
+                }
+                ++nodeIndex;
+                if (node.next != nodeIndex)
+                    continue;
+                rangeBegin = contourBegin+node.begin;
+                rangeEnd = contourBegin+node.end;
+            } else
+                ++nodeIndex;
+
+            for (int edge = rangeBegin; edge < rangeEnd; ++edge) {
+                EdgeCache *edgeCache = &shapeEdgeCache[BATCH_SIZE*edge];
+                bool relevant[BATCH_SIZE];
+                bool anyRelevant = false;
+                for (int i = 0; i < BATCH_SIZE; ++i)
+                    anyRelevant |= relevant[i] = edgeSelectors[i]->isEdgeRelevant(edgeCache[i], shape.edges[edge]);
+                if (!anyRelevant)
+                    continue;
+                SignedDistance batchDistances[BATCH_SIZE];
+                double batchParams[BATCH_SIZE];
+                shape.signedDistances(origins, edge, batchDistances, batchParams);
+                for (int i = 0; i < BATCH_SIZE; ++i) {
+                    if (relevant[i])
+                        edgeSelectors[i]->addEdge(edgeCache[i], shape.edges[edge], batchDistances[i], batchParams[i]);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < BATCH_SIZE; ++i)
+        distances[i] = contourCombiners[i].distance();
+}
+
+template <class ContourCombiner, typename Real>
+const ContourCombiner &CompiledShapeDistanceFinder<ContourCombiner, Real>::getContourCombiner(int origin) const {
+    return contourCombiners[origin];
+}
+
+}
@@ -25,6 +25,8 @@ public:
     void setMinDeviationRatio(double minDeviationRatio);
     /// Sets the minimum ratio between the pre-correction distance error and the post-correction distance error.
     void setMinImproveRatio(double minImproveRatio);
+    /// Sets the number of row bands the passes are split into (see GeneratorConfig::threadCount). Defaults to one, the calling thread only.
+    void setThreadCount(int threadCount);
     /// Flags all texels that are interpolated at corners as protected.
     void protectCorners(const Shape &shape);
     /// Flags all texels that contribute to edges as protected.
@@ -38,6 +40,9 @@ public:
     /// Flags texels that are expected to cause interpolation artifacts based on analysis of the SDF and comparison with the exact shape distance.
     template <template <typename> class ContourCombiner, int N>
     void findErrors(const BitmapConstRef<float, N> &sdf, const Shape &shape);
+    /// As above, but if nearestEdges has pixels, only the nearest edges recorded at each texel and its neighbor are considered for the shape distance (see msdfErrorCorrection).
+    template <template <typename> class ContourCombiner, int N>
+    void findErrors(const BitmapConstRef<float, N> &sdf, const Shape &shape, const BitmapConstRef<int, 3> &nearestEdges);
     /// Modifies the MSDF so that all texels with the error flag are converted to single-channel.
     template <int N>
     void apply(const BitmapRef<float, N> &sdf) const;
@@ -49,6 +54,7 @@ private:
     SDFTransformation transformation;
     double minDeviationRatio;
     double minImproveRatio;
+    int threadCount;
 
 };
 
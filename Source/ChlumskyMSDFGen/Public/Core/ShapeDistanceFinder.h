@@ -5,6 +5,7 @@
 #include "Vector2.hpp"
 #include "edge-selectors.h"
 #include "contour-combiners.h"
+#include "ShapeEdgeIndex.h"
 
 namespace msdfgen {
 
@@ -15,16 +16,19 @@ class ShapeDistanceFinder {
 public:
     typedef typename ContourCombiner::DistanceType DistanceType;
 
-    // Passed shape object must persist until the distance finder is destroyed!
-    explicit ShapeDistanceFinder(const Shape &shape);
+    // Passed shape object (and edge index, if any) must persist until the distance finder is destroyed!
+    explicit ShapeDistanceFinder(const Shape &shape, const ShapeEdgeIndex *edgeIndex = NULL);
     /// Finds the distance from origin. Not thread-safe! Is fastest when subsequent queries are close together.
     DistanceType distance(const Point2 &origin);
+    /// Returns the contour combiner, which holds the edges selected by the last distance query.
+    const ContourCombiner &getContourCombiner() const;
 
     /// Finds the distance between shape and origin. Does not allocate result cache used to optimize performance of multiple queries.
     static DistanceType oneShotDistance(const Shape &shape, const Point2 &origin);
 
 private:
     const Shape &shape;
+    const ShapeEdgeIndex *edgeIndex;
     ContourCombiner contourCombiner;
     std::vector<typename ContourCombiner::EdgeSelectorType::EdgeCache> shapeEdgeCache;
 
@@ -4,7 +4,7 @@
 namespace msdfgen {
 
 template <class ContourCombiner>
-ShapeDistanceFinder<ContourCombiner>::ShapeDistanceFinder(const Shape &shape) : shape(shape), contourCombiner(shape), shapeEdgeCache(shape.edgeCount()) { }
+ShapeDistanceFinder<ContourCombiner>::ShapeDistanceFinder(const Shape &shape, const ShapeEdgeIndex *edgeIndex) : shape(shape), edgeIndex(edgeIndex), contourCombiner(shape), shapeEdgeCache(shape.edgeCount()) { }
 
 template <class ContourCombiner>
 typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<ContourCombiner>::distance(const Point2 &origin) {
@@ -15,6 +15,34 @@ typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<
     typename ContourCombiner::EdgeSelectorType::EdgeCache *edgeCache = shapeEdgeCache.empty() ? NULL : &shapeEdgeCache[0];
 #endif
 
+    if (edgeIndex) {
+        for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
+            int contourIndex = int(contour-shape.contours.begin());
+            int edgeCount = (int) contour->edges.size();
+            if (edgeCount > 0) {
+                typename ContourCombiner::EdgeSelectorType &edgeSelector = contourCombiner.edgeSelector(contourIndex);
+
+                // Leaves are visited in order and position k holds the same edge and cache entry as the k-th step of the unindexed loop below, so edges are added in an identical sequence
+                const EdgeHolder *edges = &contour->edges[0];
+                int nodeEnd = edgeIndex->contourNodes[contourIndex+1];
+                for (int nodeIndex = edgeIndex->contourNodes[contourIndex]; nodeIndex < nodeEnd;) {
+                    const ShapeEdgeIndex::Node &node = edgeIndex->nodes[nodeIndex];
+                    if (!edgeSelector.isEdgeDistanceRelevant(ShapeEdgeIndex::boundsDistance(node.bounds, origin))) {
+                        nodeIndex = node.next;
+                        continue;
+                    }
+                    if (node.next == nodeIndex+1) {
+                        for (int k = node.begin; k < node.end; ++k)
+                            edgeSelector.addEdge(edgeCache[k], edges[(k+edgeCount-2)%edgeCount], edges[(k+edgeCount-1)%edgeCount], edges[k]);
+                    }
+                    ++nodeIndex;
+                }
+            }
+            edgeCache += edgeCount;
+        }
+        return contourCombiner.distance();
+    }
+
     for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
         if (!contour->edges.empty()) {
             typename ContourCombiner::EdgeSelectorType &edgeSelector = contourCombiner.edgeSelector(int(contour-shape.contours.begin()));
@@ -33,6 +61,11 @@ typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<
     return contourCombiner.distance();
 }
 
+template <class ContourCombiner>
+const ContourCombiner &ShapeDistanceFinder<ContourCombiner>::getContourCombiner() const {
+    return contourCombiner;
+}
+
 template <class ContourCombiner>
 typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<ContourCombiner>::oneShotDistance(const Shape &shape, const Point2 &origin) {
     ContourCombiner contourCombiner(shape);
@@ -0,0 +1,42 @@
+
+#pragma once
+
+#include <vector>
+#include "Vector2.hpp"
+#include "Shape.h"
+
+// Maximum number of edges stored in a single leaf of the edge index
+#define MSDFGEN_EDGE_INDEX_LEAF_SIZE 4
+
+namespace msdfgen {
+
+/// Bounding volume hierarchy over the edges of each contour of a Shape, used by ShapeDistanceFinder to skip groups of edges that cannot be nearer than the current distance.
+/// Nodes cover contiguous ranges of a contour's edges, so visiting the leaves in order produces the same edge sequence as iterating the contour directly.
+class ShapeEdgeIndex {
+
+public:
+    struct Node {
+        Shape::Bounds bounds;
+        /// Range of edge positions covered by this node. Position k refers to the same edge as the k-th step of ShapeDistanceFinder's contour loop.
+        int begin, end;
+        /// Index of the first node after this node's subtree. A node is a leaf if this is the next node.
+        int next;
+    };
+
+    // Passed shape object must not be modified until the edge index is destroyed!
+    explicit ShapeEdgeIndex(const Shape &shape);
+
+    /// Nodes of all contours in depth-first order.
+    std::vector<Node> nodes;
+    /// Index of each contour's root node. Contour i's nodes span [contourNodes[i], contourNodes[i+1]).
+    std::vector<int> contourNodes;
+
+    /// Returns the distance from p to the nearest point of the bounds, or zero if p is inside.
+    static double boundsDistance(const Shape::Bounds &bounds, const Point2 &p);
+
+private:
+    int buildNode(const Contour &contour, int begin, int end);
+
+};
+
+}
@@ -3,6 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Shape.h"
+#include "CompiledShape.h"
 #include "edge-selectors.h"
 
 namespace msdfgen {
@@ -16,9 +17,12 @@ public:
     typedef typename EdgeSelector::DistanceType DistanceType;
 
     explicit SimpleContourCombiner(const Shape &shape);
+    explicit SimpleContourCombiner(const CompiledShapeBase &shape);
     void reset(const Point2 &p);
     EdgeSelector &edgeSelector(int i);
     DistanceType distance() const;
+    /// Returns a selector holding the nearest edges of the whole shape.
+    EdgeSelector mergedEdgeSelector() const;
 
 private:
     EdgeSelector shapeEdgeSelector;
@@ -34,9 +38,12 @@ public:
     typedef typename EdgeSelector::DistanceType DistanceType;
 
     explicit OverlappingContourCombiner(const Shape &shape);
+    explicit OverlappingContourCombiner(const CompiledShapeBase &shape);
     void reset(const Point2 &p);
     EdgeSelector &edgeSelector(int i);
     DistanceType distance() const;
+    /// Returns a selector holding the nearest edges of the whole shape, regardless of which contours the distance was taken from.
+    EdgeSelector mergedEdgeSelector() const;
 
 private:
     Point2 p;
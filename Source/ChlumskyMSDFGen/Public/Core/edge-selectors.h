@@ -16,6 +16,21 @@ struct MultiAndTrueDistance : MultiDistance {
     double a;
 };
 
+/// The properties of an edge that the edge selectors need besides its distance, which only depend on the edge and its neighbors and can therefore be prepared once per shape.
+struct PreparedEdge {
+    const EdgeSegment *segment;
+    EdgeColor color;
+    /// End points of the edge.
+    Point2 a, b;
+    /// Normalized directions of the edge at its end points.
+    Vector2 aDir, bDir;
+    /// Normalized directions halfway between the edge's end directions and those of the adjacent edges, which bound the edge's perpendicular distance domain.
+    Vector2 aDomainDir, bDomainDir;
+
+    PreparedEdge();
+    PreparedEdge(const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+};
+
 /// Selects the nearest edge by its true distance.
 class TrueDistanceSelector {
 
@@ -31,6 +46,12 @@ public:
 
     void reset(const Point2 &p);
     void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    /// Returns false if the edge's previously cached distance rules out it affecting the result, so that its distance need not be evaluated.
+    bool isEdgeRelevant(const EdgeCache &cache, const PreparedEdge &edge) const;
+    /// Adds an edge whose distance from the current point has already been evaluated.
+    void addEdge(EdgeCache &cache, const PreparedEdge &edge, const SignedDistance &distance, double param);
+    /// Returns false if edges that are at least minEdgeDistance away from the current point cannot affect the result.
+    bool isEdgeDistanceRelevant(double minEdgeDistance) const;
     void merge(const TrueDistanceSelector &other);
     DistanceType distance() const;
 
@@ -62,6 +83,8 @@ public:
     void merge(const PerpendicularDistanceSelectorBase &other);
     double computeDistance(const Point2 &p) const;
     SignedDistance trueDistance() const;
+    /// Returns the edge with the smallest true distance, or NULL if no edge has been added.
+    const EdgeSegment *nearestEdge() const;
 
 private:
     SignedDistance minTrueDistance;
@@ -78,8 +101,16 @@ class PerpendicularDistanceSelector : public PerpendicularDistanceSelectorBase {
 public:
     typedef double DistanceType;
 
+    using PerpendicularDistanceSelectorBase::isEdgeRelevant;
+
     void reset(const Point2 &p);
     void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    /// Returns false if the edge's previously cached distances rule out it affecting the result, so that its distance need not be evaluated.
+    bool isEdgeRelevant(const EdgeCache &cache, const PreparedEdge &edge) const;
+    /// Adds an edge whose distance from the current point has already been evaluated.
+    void addEdge(EdgeCache &cache, const PreparedEdge &edge, const SignedDistance &distance, double param);
+    /// Always true - perpendicular distances extend beyond the edge itself, so the edge's distance does not rule it out.
+    bool isEdgeDistanceRelevant(double minEdgeDistance) const;
     DistanceType distance() const;
 
 private:
@@ -96,9 +127,17 @@ public:
 
     void reset(const Point2 &p);
     void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    /// Returns false if the edge's previously cached distances rule out it affecting the result in any of its channels, so that its distance need not be evaluated.
+    bool isEdgeRelevant(const EdgeCache &cache, const PreparedEdge &edge) const;
+    /// Adds an edge whose distance from the current point has already been evaluated.
+    void addEdge(EdgeCache &cache, const PreparedEdge &edge, const SignedDistance &distance, double param);
+    /// Always true - perpendicular distances extend beyond the edge itself, so the edge's distance does not rule it out.
+    bool isEdgeDistanceRelevant(double minEdgeDistance) const;
     void merge(const MultiDistanceSelector &other);
     DistanceType distance() const;
     SignedDistance trueDistance() const;
+    /// Retrieves the nearest edge of each of the three color channels, NULL for channels without edges.
+    void nearestEdges(const EdgeSegment *edges[3]) const;
 
 private:
     Point2 p;
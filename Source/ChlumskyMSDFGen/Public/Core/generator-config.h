@@ -43,16 +43,35 @@ struct CHLUMSKYMSDFGEN_API ErrorCorrectionConfig {
     double minImproveRatio;
     /// An optional buffer to avoid dynamic allocation. Must have at least as many bytes as the MSDF has pixels.
     byte *buffer;
+    /// Specifies whether the generator records the nearest edge of each channel at every texel, so that exact shape distance checks only consider the edges recorded at the texel and its neighbor instead of the whole shape.
+    /// Much faster for shapes with many edges, at the cost of checks that are approximate where a different edge is nearest between two texels. Has no effect for DO_NOT_CHECK_DISTANCE.
+    bool useNearestEdges;
 
-    inline explicit ErrorCorrectionConfig(Mode mode = EDGE_PRIORITY, DistanceCheckMode distanceCheckMode = CHECK_DISTANCE_AT_EDGE, double minDeviationRatio = defaultMinDeviationRatio, double minImproveRatio = defaultMinImproveRatio, byte *buffer = NULL) : mode(mode), distanceCheckMode(distanceCheckMode), minDeviationRatio(minDeviationRatio), minImproveRatio(minImproveRatio), buffer(buffer) { }
+    inline explicit ErrorCorrectionConfig(Mode mode = EDGE_PRIORITY, DistanceCheckMode distanceCheckMode = CHECK_DISTANCE_AT_EDGE, double minDeviationRatio = defaultMinDeviationRatio, double minImproveRatio = defaultMinImproveRatio, byte *buffer = NULL) : mode(mode), distanceCheckMode(distanceCheckMode), minDeviationRatio(minDeviationRatio), minImproveRatio(minImproveRatio), buffer(buffer), useNearestEdges(false) { }
 };
 
 /// The configuration of the distance field generator algorithm.
 struct GeneratorConfig {
     /// Specifies whether to use the version of the algorithm that supports overlapping contours with the same winding. May be set to false to improve performance when no such contours are present.
     bool overlapSupport;
+    /// Number of contiguous row bands the output is split into, each processed by a single worker, so a non-zero value also limits how many threads run at once. Zero splits it into MSDFGEN_ROW_BANDS_PER_THREAD bands per available worker thread, one generates on the calling thread only.
+    int threadCount;
+    /// Specifies whether to build a bounding volume hierarchy over the shape's edges so that distant edges can be skipped. Output is identical either way, but shapes with many edges are generated much faster.
+    bool useEdgeIndex;
+    /// Specifies whether to flatten the shape into a CompiledShape, whose edges are evaluated in SIMD batches without virtual calls. Output is the same either way up to floating point rounding.
+    bool useCompiledShape;
+    /// Specifies whether the compiled shape evaluates its distances in single precision, which batches twice as many values per register. Distances stay within a small fraction of a pixel, enough for 8 bit outputs. Has no effect without useCompiledShape.
+    bool singlePrecision;
+    /// Algorithm the compiled shape uses to find the closest point of cubic curves. Has no effect without useCompiledShape.
+    enum CubicSearch {
+        /// Iterates from MSDFGEN_CUBIC_SEARCH_STARTS+1 evenly spaced points along every curve, the same as CubicSegment::signedDistance.
+        UNIFORM_CUBIC_SEARCH,
+        /// Splits every curve once into sections, at MSDFGEN_CUBIC_SEARCH_STARTS even intervals and where either coordinate is at an extremum. Only the sections where the distance turns from decreasing to increasing are searched, with Newton's method safeguarded by bisection.
+        /// Usually a single section brackets the closest point, so far fewer iterations are needed. Distances may differ from the uniform search far from tightly bent curves, where a section can hide a nearer point between two farther ends.
+        BRACKETED_CUBIC_SEARCH
+    } cubicSearch;
 
-    inline explicit GeneratorConfig(bool overlapSupport = true) : overlapSupport(overlapSupport) { }
+    inline explicit GeneratorConfig(bool overlapSupport = true, int threadCount = 0, bool useEdgeIndex = true, bool useCompiledShape = true, bool singlePrecision = false, CubicSearch cubicSearch = UNIFORM_CUBIC_SEARCH) : overlapSupport(overlapSupport), threadCount(threadCount), useEdgeIndex(useEdgeIndex), useCompiledShape(useCompiledShape), singlePrecision(singlePrecision), cubicSearch(cubicSearch) { }
 };
 
 /// The configuration of the multi-channel distance field generator algorithm.
@@ -1,14 +1,21 @@
 ﻿// Copyright (c) Richard Meredith AB. All Rights Reserved
 
 #include "Generation/Bitmap/RTMSDF_BitmapGeneration.h"
+#include "Generation/Bitmap/RTMSDF_BitmapGenerationSettings.h"
+#include "Generation/Bitmap/RTMSDF_DistanceTransform.h"
 #include "Generation/Bitmap/RTMSDF_QuadTree.h"
 #include "Generation/Common/RTMSDF_Buffers.h"
+#include "Generation/Common/RTMSDF_PixelFormats.h"
+#include "Generation/Common/RTMSDF_Utilities.h"
 #include "Logging/LogMacros.h"
 #include "Misc/ScopeExit.h"
 #include "Module/RTMSDF.h"
 #include "Async/ParallelFor.h"
 
-#define TREESEARCH_THREAD_ROWS 0 // 1 to put each row of the SDF on a thread, vs each pixel
+#define TREESEARCH_PACKET_SIZE 2 // Width and height of the square blocks of SDF pixels that are searched together, sharing one traversal of the edge tree
+#define TREESEARCH_NARROW_BAND_CELL_SIZE 16 // Size in source pixels of the cells of the grid used to find packets that are out of range of every edge
+#define TREESEARCH_DEFAULT_TILE_SIZE 32 // Search tile size used when callers don't pass one. Callers that generate often can find the fastest size for the machine with FindBestSearchTileSize()
+#define GENERATION_TILE_SLOTS 4 // Most tiles generated at once when generating in tiles. Each tile already searches its pixels in parallel, so a few are enough to keep every thread busy
 
 namespace RTM::SDF
 {
@@ -28,9 +35,13 @@ namespace RTM::SDF
 			return TransformPos(fromBufferDef.Width, fromBufferDef.Height, toBufferDef.Width, toBufferDef.Height, fromVec, toScale);
 		}
 
-		static uint8 ComputePixelValue(FVector2f pos, int width, int height, const uint8* buffer, int pixelWidth, int channelOffset)
+		// Bilinear sample of a channel, in the channel's own units
+		template<typename TFormat>
+		static float ComputePixelValue(FVector2f pos, const typename TFormat::TChannel* buffer, const FSDFBufferDef& bufferDef, int channelOffset)
 		{
-			auto index = [width, pixelWidth, channelOffset](int x, int y) { return (y * width + x) * pixelWidth + channelOffset; };
+			const int width = bufferDef.Width;
+			const int height = bufferDef.Height;
+			auto value = [buffer, width, channelOffset](int x, int y) { return TFormat::FTraits::ToFloat(buffer[(static_cast<size_t>(y) * width + x) * TFormat::NumChannels + channelOffset]); };
 			pos = FVector2f(FMath::Clamp(pos.X, 0.0f, width - 1.0f), FMath::Clamp(pos.Y, 0.0f, height - 1.0f));
 			const int top = FMath::FloorToInt(pos.Y);
 			const int left = FMath::FloorToInt(pos.X);
@@ -39,226 +50,1322 @@ namespace RTM::SDF
 			const float bottomWeight = pos.Y - top;
 			const float rightWeight = pos.X - left;
 
-			const uint8 lt = buffer[index(left, top)];
-			const uint8 rt = buffer[index(right, top)];
-			const uint8 lb = buffer[index(left, bottom)];
-			const uint8 rb = buffer[index(right, bottom)];
+			const float lt = value(left, top);
+			const float rt = value(right, top);
+			const float lb = value(left, bottom);
+			const float rb = value(right, bottom);
 
 			const float topVal = lt * (1.0f - rightWeight) + rt * rightWeight;
 			const float bottomVal = lb * (1.0f - rightWeight) + rb * rightWeight;
-			return static_cast<uint8>(FMath::RoundToInt(topVal * (1.0f - bottomWeight) + bottomVal * bottomWeight));
+			return topVal * (1.0f - bottomWeight) + bottomVal * bottomWeight;
 		}
 
-		static uint8 ComputePixelValue(FVector2f pos, const uint8* buffer, const FSDFBufferDef& bufferDef, int channelOffset)
+		// Writes a normalized distance to one channel of an SDF pixel, at the precision of the SDF buffer's format
+		static void WriteDistance(uint8* sdfBuffer, const FSDFBufferDef& sdfBufferDef, size_t channelIdx, float distN)
 		{
-			return ComputePixelValue(pos, bufferDef.Width, bufferDef.Height, buffer, bufferDef.NumChannels, channelOffset);
+			switch(sdfBufferDef.Format)
+			{
+				case TSF_G16:
+					reinterpret_cast<uint16*>(sdfBuffer)[channelIdx] = TChannelTraits<uint16>::FromUnit(distN);
+					break;
+#if RTMSDF_WITH_R16F_SOURCE
+				case TSF_R16F:
+					reinterpret_cast<FFloat16*>(sdfBuffer)[channelIdx] = TChannelTraits<FFloat16>::FromUnit(distN);
+					break;
+#endif
+				default:
+					sdfBuffer[channelIdx] = TChannelTraits<uint8>::FromUnit(distN);
+					break;
+			}
 		}
-	}
 
-	void CreateDistanceField(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, const float* intersectionBuffer, const FSDFBufferDef& intersectionBufferDef, int numIntersections, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping)
-	{
-		FQuadTree tree(sourceBufferDef.Width, sourceBufferDef.Height, numIntersections, numIntersections * 2);
-		PopulateEdgeTree(intersectionBuffer, intersectionBufferDef, tree);
-		FindDistances(tree, sourceBuffer, sourceBufferDef, outSDFBuffer, sdfBufferDef, mapping);
-
-		// TODO - remove this once we're sure that branch prediction isn't working
-		int hits = tree.BranchHits;
-		int misses = tree.BranchMisses;
-		UE_LOG(RTMSDF, Verbose, TEXT("Branch Hits/Misses %d / %d (%.02f hitrate)"), hits, misses, (hits+misses > 0) ? (hits*100.0f) / (hits+misses) : 0.0f);
-	}
+		// Writes the same normalized distance to one channel of every pixel in a rect. Rows of single channel 8 bit SDFs are contiguous, so each is filled with a single write
+		static void FillDistance(uint8* sdfBuffer, const FSDFBufferDef& sdfBufferDef, const FIntRect& rect, int channelOffset, float distN)
+		{
+			const bool contiguousRows = sdfBufferDef.NumChannels == 1 && GetBytesPerChannel(sdfBufferDef) == 1;
+			for(int y = rect.Min.Y; y < rect.Max.Y; ++y)
+			{
+				const size_t rowStart = static_cast<size_t>(y) * sdfBufferDef.Width + rect.Min.X;
+				if(contiguousRows)
+				{
+					FMemory::Memset(sdfBuffer + rowStart, TChannelTraits<uint8>::FromUnit(distN), rect.Width());
+					continue;
+				}
 
-	void SetChannelUniformValue(uint8* buffer, const FSDFBufferDef& bufferDef, uint8 channelOffset, uint8 value)
-	{
-		const int bufferLen = bufferDef.GetBufferLen();
-		for(int i = 0; i < bufferLen; i += bufferDef.NumChannels)
-			buffer[i + channelOffset] = value;
-	}
+				for(int x = 0; x < rect.Width(); ++x)
+					WriteDistance(sdfBuffer, sdfBufferDef, (rowStart + x) * sdfBufferDef.NumChannels + channelOffset, distN);
+			}
+		}
 
-	void CopyChannelValues(uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8 sourceChannelOffset, uint8* targetBuffer, const FSDFBufferDef& targetBufferDef, uint8 targetChannelOffset)
-	{
-		check(sourceBufferDef.Width == targetBufferDef.Width);
-		check(sourceBufferDef.Height == targetBufferDef.Height);
-		const int numPixels = sourceBufferDef.Width * sourceBufferDef.Height;
-		for(int i = 0; i < numPixels; ++i)
-			targetBuffer[i * targetBufferDef.NumChannels + targetChannelOffset] = sourceBuffer[i * sourceBufferDef.NumChannels + sourceChannelOffset];
-	}
+		template<typename TChannel>
+		static float FindIntersection(TChannel value, TChannel nextValue)
+		{
+			// Position of the threshold crossing between two adjacent pixels, as a fraction of the distance between them. Negative if they don't cross it
+			using FTraits = TChannelTraits<TChannel>;
+			const float numerator = FTraits::Threshold - FTraits::ToFloat(value);
+			const float denominator = FTraits::ToFloat(nextValue) - FTraits::ToFloat(value);
+			const float intersection = denominator != 0.0f ? numerator / denominator : -FLT_MAX;
+			return intersection > 1.0f ? -FLT_MAX : intersection;
+		}
 
-	bool CreateDistanceField(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping)
-	{
-		FSDFBufferDef intersectionBufferDef(sourceBufferDef.Width, sourceBufferDef.Height, 1);
+		template<typename TFormat>
+		static void FindRowEdges(const typename TFormat::TChannel* sourceBuffer, const FSDFBufferDef& sourceBufferDef, int channelOffset, int y, TArray<FVector2f>& outEdgePoints)
+		{
+			auto value = [&](int px, int py) { return sourceBuffer[(static_cast<size_t>(py) * sourceBufferDef.Width + px) * TFormat::NumChannels + channelOffset]; };
 
-		float* const sourceIntersections = static_cast<float*>(FMemory::Malloc(intersectionBufferDef.GetBufferLen() * 2 * sizeof(float)));
-		ON_SCOPE_EXIT { FMemory::Free(sourceIntersections); };
+			const bool bottomRow = y == sourceBufferDef.Height - 1;
+			for(int x = 0; x < sourceBufferDef.Width; x++)
+			{
+				// Marching squares over the cell with this pixel at its top left. Cells on the last row / column only have their top / left edges
+				const bool rightmostCol = x == sourceBufferDef.Width - 1;
+				const typename TFormat::TChannel topLeft = value(x, y);
+				const float topIntersection = rightmostCol ? -FLT_MAX : FindIntersection(topLeft, value(x + 1, y));
+				const float leftIntersection = bottomRow ? -FLT_MAX : FindIntersection(topLeft, value(x, y + 1));
+				const float rightIntersection = rightmostCol ? -1.0f : bottomRow ? -FLT_MAX : FindIntersection(value(x + 1, y), value(x + 1, y + 1));
+				const float bottomIntersection = bottomRow ? -1.0f : rightmostCol ? -FLT_MAX : FindIntersection(value(x, y + 1), value(x + 1, y + 1));
 
-		uint32 numIntersections = 0;
+				TArray<FVector2f, TFixedAllocator<4>> intersections;
 
-		const bool foundIntersections = FindIntersections(sourceBuffer, sourceBufferDef, sourceIntersections, intersectionBufferDef, mapping.SourceChannel, numIntersections);
-		if(foundIntersections)
-			CreateDistanceField(sourceBuffer, sourceBufferDef, sourceIntersections, intersectionBufferDef, numIntersections, outSDFBuffer, sdfBufferDef, mapping);
+				if(topIntersection >= 0.0f)
+					intersections.Add(FVector2f(x + topIntersection, y));
 
-		return foundIntersections;
-	}
+				if(bottomIntersection >= 0.0f)
+					intersections.Add(FVector2f(x + bottomIntersection, y + 1));
 
-	bool FindIntersections(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, float* outIntersectionBuffer, const FSDFBufferDef& intersectionBufferDef, int channelOffset, uint32& outNumIntersections)
-	{
-		const uint64 cyclesStart = FPlatformTime::Cycles();
-		std::atomic_uint32_t numFound = false;
-		ParallelFor(intersectionBufferDef.Height, [&](const int eY)
+				if(leftIntersection > 0.0f && leftIntersection < 1.0f)
+					intersections.Add(FVector2f(x, y + leftIntersection));
+
+				if(rightIntersection > 0.0f && rightIntersection < 1.0f)
+					intersections.Add(FVector2f(x + 1, y + rightIntersection));
+
+				const int numPoints = intersections.Num();
+				if(numPoints >= 2)
+				{
+					outEdgePoints.Add(intersections[0]);
+					outEdgePoints.Add(intersections[1]);
+				}
+				if(numPoints == 4)
+				{
+					outEdgePoints.Add(intersections[2]);
+					outEdgePoints.Add(intersections[3]);
+				}
+			}
+		}
+
+		// Distance from the centre of a pixel to a straight edge crossing it, from the pixel's coverage and the edge's normal. Positive when the centre is outside the edge
+		// Inverts the area of the triangle or trapezoid that an edge cuts from a unit pixel, as in Gustavson & Strand's anti-aliased euclidean distance transform
+		static float FindCoverageEdgeDistance(const FVector2f& normal, float coverage)
 		{
-			const bool bottomRow = eY == intersectionBufferDef.Height - 1;
-			for(int eX = 0; eX < intersectionBufferDef.Width; eX++)
+			float gx = FMath::Abs(normal.X);
+			float gy = FMath::Abs(normal.Y);
+			if(gx < gy)
+				Swap(gx, gy);
+
+			if(gy <= 0.0f)
+				return 0.5f - coverage;
+
+			const float cornerCoverage = 0.5f * gy / gx;
+			if(coverage < cornerCoverage)
+				return 0.5f * (gx + gy) - FMath::Sqrt(2.0f * gx * gy * coverage);
+
+			if(coverage < 1.0f - cornerCoverage)
+				return (0.5f - coverage) * gx;
+
+			return -0.5f * (gx + gy) + FMath::Sqrt(2.0f * gx * gy * (1.0f - coverage));
+		}
+
+		// Buffers for FindRowCoverageEdges, reused by every row of a band rather than allocated per row
+		struct FCoverageRowScratch
+		{
+			TArray<bool> CoverageRows[2];
+			TArray<FVector2f> CellEdgePoints;
+			int NextRowY = INDEX_NONE;	// Row held in CoverageRows[1], so the next row in order can take it instead of finding it again
+		};
+
+		/* Edges of an anti-aliased source. Partially covered pixels beside the threshold each add a one pixel edge along their tangent, placed from their coverage and gradient
+		 * Cells with none of those pixels at their corners are hard edged, so keep their marching squares edges */
+		template<typename TFormat>
+		static void FindRowCoverageEdges(const typename TFormat::TChannel* sourceBuffer, const FSDFBufferDef& sourceBufferDef, int channelOffset, int y, FCoverageRowScratch& scratch, TArray<FVector2f>& outEdgePoints)
+		{
+			using FTraits = typename TFormat::FTraits;
+			const int width = sourceBufferDef.Width;
+			const int height = sourceBufferDef.Height;
+			auto value = [&](int px, int py) { return FTraits::ToFloat(sourceBuffer[(static_cast<size_t>(FMath::Clamp(py, 0, height - 1)) * width + FMath::Clamp(px, 0, width - 1)) * TFormat::NumChannels + channelOffset]); };
+
+			// Partial coverage away from the threshold is shading or noise rather than an edge, so is ignored
+			auto isCoveragePixel = [&](int px, int py)
 			{
-				// NOTE: When we come back to wrapping this stuff, might be worth having the invalid row / column either
-				//	- For wrapped, read on the other side
-				//	- For non-wrapped, read the current pixel (will create a 0 denominator and thus no edge
-				//	Should be cleaner
+				const float centre = value(px, py);
+				if(centre <= 0.0f || centre >= FTraits::MaxValue)
+					return false;
+
+				bool anyOutside = false;
+				bool anyInside = false;
+				for(int dy = -1; dy <= 1; ++dy)
+				{
+					for(int dx = -1; dx <= 1; ++dx)
+					{
+						const bool outside = value(px + dx, py + dy) < FTraits::Threshold;
+						anyOutside |= outside;
+						anyInside |= !outside;
+					}
+				}
 
-				const bool rightmostCol = eX == intersectionBufferDef.Width - 1;
+				return anyOutside && anyInside;
+			};
 
-				const int currPixIdx = eY * sourceBufferDef.Width + eX;
-				const int currValueIdx = currPixIdx * sourceBufferDef.NumChannels + channelOffset;
-				const int rightValueIdx = (currPixIdx + 1) * sourceBufferDef.NumChannels + channelOffset;
-				const int downValueIdx = (currPixIdx + sourceBufferDef.Width) * sourceBufferDef.NumChannels + channelOffset;
+			TArray<bool>* coverageRows = scratch.CoverageRows;
+			auto findCoverageRow = [&](int row)
+			{
+				coverageRows[row].SetNumUninitialized(width);
+				for(int x = 0; x < width; ++x)
+					coverageRows[row][x] = y + row < height && isCoveragePixel(x, y + row);
+			};
 
-				const int intersectionRightIdx = (eY * intersectionBufferDef.Width + eX) * 2;
-				const int intersectionDownIdx = intersectionRightIdx + 1;
+			if(scratch.NextRowY == y)
+				Swap(coverageRows[0], coverageRows[1]);
+			else
+				findCoverageRow(0);
 
-				const uint8 currValue = sourceBuffer[currValueIdx];
-				const uint8 rightPixValue = sourceBuffer[rightValueIdx];
-				const uint8 downPixValue = sourceBuffer[downValueIdx];
+			findCoverageRow(1);
+			scratch.NextRowY = y + 1;
 
-				// TODO - maybe keep demoninators and numerators as uint8 until we reach the division
-				const float numerator = (127 - currValue);
-				const float denominatorX = rightmostCol ? 0.0f : static_cast<float>(rightPixValue - currValue);
-				const float denominatorY = bottomRow ? 0.0f : static_cast<float>(downPixValue - currValue);
-				const float intersectionTop = denominatorX != 0.0f ? numerator / denominatorX : -FLT_MAX;
-				const float intersectionLeft = denominatorY != 0.0f ? numerator / denominatorY : -FLT_MAX;
+			// Sobel-like gradient, with the weights that make it isotropic for the edge directions
+			constexpr float sideWeight = 1.41421356f;
+			for(int x = 0; x < width; ++x)
+			{
+				if(!coverageRows[0][x])
+					continue;
 
-				outIntersectionBuffer[intersectionRightIdx] = intersectionTop > 1.0f ? -FLT_MAX : intersectionTop;
-				outIntersectionBuffer[intersectionDownIdx] = intersectionLeft > 1.0f ? -FLT_MAX : intersectionLeft;
+				auto sample = [&](int dx, int dy) { return value(x + dx, y + dy); };
+				const FVector2f gradient(
+					sample(1, -1) + sideWeight * sample(1, 0) + sample(1, 1) - sample(-1, -1) - sideWeight * sample(-1, 0) - sample(-1, 1),
+					sample(-1, 1) + sideWeight * sample(0, 1) + sample(1, 1) - sample(-1, -1) - sideWeight * sample(0, -1) - sample(1, -1));
 
-				if(outIntersectionBuffer[intersectionRightIdx] >= 0.0f)
-					++numFound;
+				// The gradient points inside, so the edge is along it from an outside centre and against it from an inside one
+				const FVector2f normal = gradient.GetSafeNormal();
+				if(normal.IsZero())
+					continue;
 
-				if(outIntersectionBuffer[intersectionDownIdx] >= 0.0f)
-					++numFound;
+				const float coverage = value(x, y) / FTraits::MaxValue;
+				const FVector2f edgePoint = FVector2f(x, y) + normal * FindCoverageEdgeDistance(normal, coverage);
+				const FVector2f halfTangent(-normal.Y * 0.5f, normal.X * 0.5f);
+				outEdgePoints.Add(edgePoint - halfTangent);
+				outEdgePoints.Add(edgePoint + halfTangent);
 			}
-		});
 
-		const uint64 cyclesEnd = FPlatformTime::Cycles();
+			TArray<FVector2f>& cellEdgePoints = scratch.CellEdgePoints;
+			cellEdgePoints.Reset();
+			FindRowEdges<TFormat>(sourceBuffer, sourceBufferDef, channelOffset, y, cellEdgePoints);
+			for(int i = 0; i + 1 < cellEdgePoints.Num(); i += 2)
+			{
+				const int cellX = FMath::Clamp(FMath::FloorToInt((cellEdgePoints[i].X + cellEdgePoints[i + 1].X) * 0.5f), 0, width - 1);
+				const int nextX = FMath::Min(cellX + 1, width - 1);
+				if(!coverageRows[0][cellX] && !coverageRows[0][nextX] && !coverageRows[1][cellX] && !coverageRows[1][nextX])
+				{
+					outEdgePoints.Add(cellEdgePoints[i]);
+					outEdgePoints.Add(cellEdgePoints[i + 1]);
+				}
+			}
+		}
 
-		outNumIntersections = numFound;
-		UE_LOG(RTMSDF, Verbose, TEXT("Num Intersections[%d] = %d (%.2fms)"), channelOffset, outNumIntersections, FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
-		return numFound > 1;
-	}
+		struct FSearchPacket
+		{
+			TArray<FIntPoint, TFixedAllocator<FQuadTree::MaxPacketSize>> Pixels;
+			TArray<FVector2f, TFixedAllocator<FQuadTree::MaxPacketSize>> SourcePositions;
+			TArray<FSearchContext, TFixedAllocator<FQuadTree::MaxPacketSize>> Searches;
+		};
 
-	bool PopulateEdgeTree(const float* intersectionBuffer, const FSDFBufferDef& intersectionBufferDef, FQuadTree& tree)
-	{
-		const uint64 cyclesStart = FPlatformTime::Cycles();
+		// Coarse grid of the cells within a distance of any edge, which is conservative so that no position in range of an edge is ever outside the band
+		struct FNarrowBand
+		{
+			int32 NumCellsX = 0;
+			int32 NumCellsY = 0;
+			int32 Border = 0;		// Cells of padding around the source, as positions just outside it can still be in range of its edges
+			TArray<bool> Cells;
 
-		for(int y = 0; y < intersectionBufferDef.Height; y++)
+			FNarrowBand(const TArray<FVector2f>& edgePoints, const FSDFBufferDef& bufferDef, float bandDistance)
+			{
+				// Edges span at most one source pixel, and bilinear samples reach one pixel further, so 2 pixels of slack cover any position within bandDistance
+				const int32 radius = FMath::CeilToInt((bandDistance + 2.0f) / TREESEARCH_NARROW_BAND_CELL_SIZE);
+				Border = radius;
+				NumCellsX = FMath::DivideAndRoundUp(bufferDef.Width, TREESEARCH_NARROW_BAND_CELL_SIZE) + Border * 2;
+				NumCellsY = FMath::DivideAndRoundUp(bufferDef.Height, TREESEARCH_NARROW_BAND_CELL_SIZE) + Border * 2;
+
+				TArray<bool> occupied;
+				occupied.Init(false, NumCellsX * NumCellsY);
+				for(const FVector2f& point : edgePoints)
+				{
+					const int32 cellIdx = GetCellIndex(point);
+					if(cellIdx != INDEX_NONE)
+						occupied[cellIdx] = true;
+				}
+
+				// Separable box dilation, by tracking the distance to the last occupied cell in each direction along every row, then every column
+				auto dilateLine = [radius](const bool* in, bool* out, int32 num, int32 stride)
+				{
+					int32 sinceOccupied = radius + 1;
+					for(int32 i = 0; i < num; ++i)
+					{
+						sinceOccupied = in[i * stride] ? 0 : FMath::Min(sinceOccupied + 1, radius + 1);
+						out[i * stride] = sinceOccupied <= radius;
+					}
+
+					sinceOccupied = radius + 1;
+					for(int32 i = num - 1; i >= 0; --i)
+					{
+						sinceOccupied = in[i * stride] ? 0 : FMath::Min(sinceOccupied + 1, radius + 1);
+						out[i * stride] |= sinceOccupied <= radius;
+					}
+				};
+
+				TArray<bool> rowsDilated;
+				rowsDilated.SetNumUninitialized(occupied.Num());
+				for(int32 y = 0; y < NumCellsY; ++y)
+					dilateLine(occupied.GetData() + y * NumCellsX, rowsDilated.GetData() + y * NumCellsX, NumCellsX, 1);
+
+				Cells.SetNumUninitialized(occupied.Num());
+				for(int32 x = 0; x < NumCellsX; ++x)
+					dilateLine(rowsDilated.GetData() + x, Cells.GetData() + x, NumCellsY, NumCellsX);
+			}
+
+			bool IsInBand(const FVector2f& pos) const
+			{
+				const int32 cellIdx = GetCellIndex(pos);
+				return cellIdx != INDEX_NONE && Cells[cellIdx];
+			}
+
+			// True if any position between minPos and maxPos is in the band
+			bool IsAnyInBand(const FVector2f& minPos, const FVector2f& maxPos) const
+			{
+				const int32 minCellX = FMath::Max(FMath::FloorToInt(minPos.X / TREESEARCH_NARROW_BAND_CELL_SIZE) + Border, 0);
+				const int32 minCellY = FMath::Max(FMath::FloorToInt(minPos.Y / TREESEARCH_NARROW_BAND_CELL_SIZE) + Border, 0);
+				const int32 maxCellX = FMath::Min(FMath::FloorToInt(maxPos.X / TREESEARCH_NARROW_BAND_CELL_SIZE) + Border, NumCellsX - 1);
+				const int32 maxCellY = FMath::Min(FMath::FloorToInt(maxPos.Y / TREESEARCH_NARROW_BAND_CELL_SIZE) + Border, NumCellsY - 1);
+				for(int32 cellY = minCellY; cellY <= maxCellY; ++cellY)
+				{
+					for(int32 cellX = minCellX; cellX <= maxCellX; ++cellX)
+					{
+						if(Cells[cellY * NumCellsX + cellX])
+							return true;
+					}
+				}
+
+				return false;
+			}
+
+		private:
+			int32 GetCellIndex(const FVector2f& pos) const
+			{
+				const int32 cellX = FMath::FloorToInt(pos.X / TREESEARCH_NARROW_BAND_CELL_SIZE) + Border;
+				const int32 cellY = FMath::FloorToInt(pos.Y / TREESEARCH_NARROW_BAND_CELL_SIZE) + Border;
+				if(cellX < 0 || cellY < 0 || cellX >= NumCellsX || cellY >= NumCellsY)
+					return INDEX_NONE;
+
+				return cellY * NumCellsX + cellX;
+			}
+		};
+
+		// Inside / outside of every output pixel in a rect, found by counting edge crossings along each output row, so that it always agrees with the extracted edges
+		// Rows are padded to whole words, so that they can be built in parallel
+		struct FSignRaster
 		{
-			for(int x = 0; x < intersectionBufferDef.Width; x++)
+			FIntRect Rect;
+			int32 WordsPerRow = 0;
+			TArray<uint64> Words;
+
+			template<typename TChannel>
+			FSignRaster(const TArray<FVector2f>& edgePoints, const TChannel* sourceBuffer, const FSDFBufferDef& sourceBufferDef, int channelOffset, const FSDFBufferDef& mappedBufferDef, const FIntPoint& sourceOrigin, const FSDFBufferDef& sdfBufferDef, const FIntRect& sdfRect, float scale)
+				: Rect(sdfRect)
 			{
-				const int currIdx = (y * intersectionBufferDef.Width + x) * 2;
-				const int nextColIdxUnsafe = (y * intersectionBufferDef.Width + (x + 1)) * 2;		// are these really unsafe?
-				const int nextRowIdxUnsafe = ((y + 1) * intersectionBufferDef.Width + x) * 2;		// TODO - should be possible to make this whole thing safe
+				WordsPerRow = FMath::DivideAndRoundUp(Rect.Width(), 64);
+				Words.SetNumZeroed(WordsPerRow * Rect.Height());
 
-				const float topIntersection = intersectionBuffer[currIdx];
-				const float leftIntersection = intersectionBuffer[currIdx + 1];
-				const float rightIntersection = (x < intersectionBufferDef.Width - 1) ? intersectionBuffer[nextColIdxUnsafe + 1] : -1.0f;
-				const float bottomIntersection = (y < intersectionBufferDef.Height - 1) ? intersectionBuffer[nextRowIdxUnsafe] : -1.0f;
+				// Counting sort of the edges by the row of the source cell they were found in. Edges never leave their cell, so a scanline can only cross edges from its own row and the row above
+				const int32 numEdges = edgePoints.Num() / 2;
+				auto edgeRow = [&](int32 e) { return FMath::Clamp(FMath::FloorToInt(FMath::Min(edgePoints[e * 2].Y, edgePoints[e * 2 + 1].Y)), 0, sourceBufferDef.Height - 1); };
+				TArray<int32> rowEdgeStart;
+				rowEdgeStart.SetNumZeroed(sourceBufferDef.Height + 1);
+				for(int32 e = 0; e < numEdges; ++e)
+					++rowEdgeStart[edgeRow(e) + 1];
 
-				TArray<FVector2f, TFixedAllocator<4>> intersections;
+				for(int32 row = 0; row < sourceBufferDef.Height; ++row)
+					rowEdgeStart[row + 1] += rowEdgeStart[row];
 
-				if(topIntersection >= 0.0f)
-					intersections.Add(FVector2f(x + topIntersection, y));
+				TArray<int32> rowCursors(rowEdgeStart.GetData(), sourceBufferDef.Height);
+				TArray<int32> rowEdges;
+				rowEdges.SetNumUninitialized(numEdges);
+				for(int32 e = 0; e < numEdges; ++e)
+					rowEdges[rowCursors[edgeRow(e)]++] = e;
 
-				if(bottomIntersection >= 0.0f)
-					intersections.Add(FVector2f(x + bottomIntersection, y + 1));
+				auto sourceValue = [&](int32 x, int32 y) { return TChannelTraits<TChannel>::ToFloat(sourceBuffer[(static_cast<size_t>(y) * sourceBufferDef.Width + x) * sourceBufferDef.NumChannels + channelOffset]); };
 
-				if(leftIntersection > 0.0f && leftIntersection < 1.0f)
-					intersections.Add(FVector2f(x, y + leftIntersection));
+				ParallelFor(Rect.Height(), [&](const int32 row)
+				{
+					// TransformPos is separable, so every pixel in an output row has the same source Y
+					const int32 y = Rect.Min.Y + row;
+					const float sourceY = FMath::Clamp(TransformPos(sdfBufferDef, mappedBufferDef, FVector2f(Rect.Min.X, y), scale).Y - sourceOrigin.Y, 0.0f, sourceBufferDef.Height - 1.0f);
+					const int32 cellRow = FMath::FloorToInt(sourceY);
 
-				if(rightIntersection > 0.0f && rightIntersection < 1.0f)
-					intersections.Add(FVector2f(x + 1, y + rightIntersection));
+					// Half open crossing test, so a scanline through an edge's end point counts exactly one of the two edges that meet there
+					TArray<float, TInlineAllocator<64>> crossings;
+					for(int32 edgeCellRow = FMath::Max(cellRow - 1, 0); edgeCellRow <= cellRow; ++edgeCellRow)
+					{
+						for(int32 i = rowEdgeStart[edgeCellRow]; i < rowEdgeStart[edgeCellRow + 1]; ++i)
+						{
+							const FVector2f& p1 = edgePoints[rowEdges[i] * 2];
+							const FVector2f& p2 = edgePoints[rowEdges[i] * 2 + 1];
+							if((p1.Y <= sourceY) != (p2.Y <= sourceY))
+								crossings.Add(p1.X + (sourceY - p1.Y) * (p2.X - p1.X) / (p2.Y - p1.Y));
+						}
+					}
+					crossings.Sort();
 
-				const int numPoints = intersections.Num();
-				if(numPoints >= 2)
+					// Start from the left edge of the source, interpolated along the column in the same way the edges' intersections were found
+					const int32 bottomRow = FMath::Min(cellRow + 1, sourceBufferDef.Height - 1);
+					const float leftValue = FMath::Lerp(sourceValue(0, cellRow), sourceValue(0, bottomRow), sourceY - cellRow);
+					bool outside = leftValue < TChannelTraits<TChannel>::Threshold;
+
+					int32 crossingIdx = 0;
+					uint64* rowWords = Words.GetData() + row * WordsPerRow;
+					for(int32 x = Rect.Min.X; x < Rect.Max.X; ++x)
+					{
+						const float sourceX = TransformPos(sdfBufferDef, mappedBufferDef, FVector2f(x, y), scale).X - sourceOrigin.X;
+						for(; crossingIdx < crossings.Num() && crossings[crossingIdx] <= sourceX; ++crossingIdx)
+							outside = !outside;
+
+						const int32 bit = x - Rect.Min.X;
+						if(outside)
+							rowWords[bit / 64] |= 1ull << (bit % 64);
+					}
+				});
+			}
+
+			bool IsOutside(int32 x, int32 y) const
+			{
+				const int32 bit = x - Rect.Min.X;
+				return (Words[(y - Rect.Min.Y) * WordsPerRow + bit / 64] >> (bit % 64)) & 1;
+			}
+		};
+
+		template<typename TEdgeSearch, typename TFormat>
+		struct FDistanceFieldChannel
+		{
+			const TEdgeSearch* EdgeSearch = nullptr;
+			const typename TFormat::TChannel* SourceBuffer = nullptr;
+			FSDFBufferDef SourceBufferDef;
+			FSDFBufferMapping Mapping;
+
+			// The full source that output pixels are mapped from, and where SourceBuffer sits within it. These differ from SourceBufferDef when generating in tiles
+			FSDFBufferDef MappedBufferDef;
+			FIntPoint SourceOrigin = FIntPoint::ZeroValue;
+
+			// Optional, packets entirely outside the band skip their search
+			const FNarrowBand* NarrowBand = nullptr;
+
+			// Optional, replaces sampling the source for the sign of each pixel
+			const FSignRaster* SignRaster = nullptr;
+		};
+
+		// NOTE - the search zones are only used by the public FindDistances. Imports clear the tiling flags and instead wrap edges into a halo around the source, so every pixel needs a single search
+		struct FChannelSearchRange
+		{
+			float HalfFieldDistance = 0.0f;
+			float SearchRange = 0.0f;
+			TArray<FVector2f> SearchZones;
+			FVector2f ZoneOffset = FVector2f(ForceInitToZero);
+
+			FChannelSearchRange(const FSDFBufferDef& sourceBufferDef, const FSDFBufferMapping& mapping)
+			{
+				HalfFieldDistance = mapping.DistanceRangeNormalized * FMath::Min(sourceBufferDef.Width, sourceBufferDef.Height) * mapping.Scale;
+				SearchRange = HalfFieldDistance * 2.0f;
+
+				SearchZones = {{0.0f, 0.0f}};
+				if(mapping.bTileX)
+					SearchZones.Append({{-1.0f, 0.0f}, {1.0f, 0.0f}});
+
+				if(mapping.bTileY)
+					SearchZones.Append({{0.0f, -1.0f}, {0.0f, 1.0f}});
+
+				if(mapping.bTileX && mapping.bTileY)
+					SearchZones.Append({{-1.0f, -1.0f}, {1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f}});
+
+				ZoneOffset = FVector2f(sourceBufferDef.Width, sourceBufferDef.Height) * mapping.Scale;
+			}
+		};
+
+		// Searches distances for all channels in a single parallel dispatch, so that small channels don't leave threads idle at the end of each channel
+		template<typename TEdgeSearch, typename TFormat>
+		static void FindDistances(const TArray<FDistanceFieldChannel<TEdgeSearch, TFormat>>& channels, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FIntRect& sdfRect, int searchTileSize)
+		{
+			if(channels.Num() == 0)
+				return;
+
+			const uint64 cyclesStart = FPlatformTime::Cycles();
+
+			TArray<FChannelSearchRange> channelRanges;
+			for(const FDistanceFieldChannel<TEdgeSearch, TFormat>& channel : channels)
+				channelRanges.Emplace(channel.MappedBufferDef, channel.Mapping);
+
+			std::atomic_uint64_t numCellsVisited = 0;
+			std::atomic_uint64_t numEdgesTested = 0;
+			std::atomic_uint64_t numSkippedPixels = 0;
+
+			static_assert(TREESEARCH_PACKET_SIZE * TREESEARCH_PACKET_SIZE <= FQuadTree::MaxPacketSize);
+			const int numPacketsX = FMath::DivideAndRoundUp(sdfRect.Width(), TREESEARCH_PACKET_SIZE);
+			const int numPacketsY = FMath::DivideAndRoundUp(sdfRect.Height(), TREESEARCH_PACKET_SIZE);
+
+			auto searchPacket = [&](const int channelIdx, const int packetX, const int packetY, FSearchPacket& packet, const FSearchPacket* seedPacket)
+			{
+				const FDistanceFieldChannel<TEdgeSearch, TFormat>& channel = channels[channelIdx];
+				const FChannelSearchRange& range = channelRanges[channelIdx];
+
+				packet.Pixels.Reset();
+				packet.SourcePositions.Reset();
+				packet.Searches.Reset();
+
+				// Packets on the right and bottom edges may be partial
+				for(int y = packetY; y < FMath::Min(packetY + TREESEARCH_PACKET_SIZE, sdfRect.Max.Y); ++y)
 				{
-					tree.AddItem(intersections[0], intersections[1]);
+					for(int x = packetX; x < FMath::Min(packetX + TREESEARCH_PACKET_SIZE, sdfRect.Max.X); ++x)
+					{
+						const FVector2f sourcePos = TransformPos(sdfBufferDef, channel.MappedBufferDef, FVector2f(x, y), channel.Mapping.Scale) - FVector2f(channel.SourceOrigin);
+
+						// Distance fields are 1-Lipschitz, so a neighbour's distance plus the step between the two pixels is an upper bound on this pixel's distance
+						// The small slack keeps the neighbour's nearest edge strictly inside the bound, so it is always re-found
+						float maxDistance = range.HalfFieldDistance;
+						int32 nearestEdge = INDEX_NONE;
+						if(seedPacket)
+						{
+							for(int s = 0; s < seedPacket->Searches.Num(); ++s)
+							{
+								const float seedDistance = FMath::Sqrt(seedPacket->Searches[s].ClosestDistanceSq) + FVector2f::Distance(sourcePos, seedPacket->SourcePositions[s]) + UE_KINDA_SMALL_NUMBER;
+								if(seedDistance < maxDistance)
+								{
+									maxDistance = seedDistance;
+									nearestEdge = seedPacket->Searches[s].NearestEdge;
+								}
+							}
+						}
+
+						packet.Pixels.Add(FIntPoint(x, y));
+						packet.SourcePositions.Add(sourcePos);
+						packet.Searches.Emplace(sourcePos, maxDistance, nearestEdge);
+					}
 				}
-				if(numPoints == 4)
+
+				// Packets outside the narrow band have no edges in range, so keep the distance they started with, exactly as a search would
+				auto isInBand = [&channel, &range](const FVector2f& sourcePos)
+				{
+					return range.SearchZones.ContainsByPredicate([&](const FVector2f& zone) { return channel.NarrowBand->IsInBand(sourcePos + zone * range.ZoneOffset); });
+				};
+
+				const bool inBand = !channel.NarrowBand || packet.SourcePositions.ContainsByPredicate(isInBand);
+				if(inBand)
+				{
+					for(auto& zone : range.SearchZones)
+					{
+						for(int p = 0; p < packet.Searches.Num(); ++p)
+							packet.Searches[p].MoveTo(packet.SourcePositions[p] + zone * range.ZoneOffset);
+
+						channel.EdgeSearch->FindDistance(MakeArrayView(packet.Searches));
+					}
+				}
+				else
+				{
+					numSkippedPixels += packet.Searches.Num();
+				}
+
+				uint64 packetCellsVisited = 0;
+				uint64 packetEdgesTested = 0;
+				bool firstOutside = false;
+				for(int p = 0; p < packet.Searches.Num(); ++p)
 				{
-					tree.AddItem(intersections[2], intersections[3]);
+					const FSearchContext& search = packet.Searches[p];
+					packetCellsVisited += search.NumCellsVisited;
+					packetEdgesTested += search.NumEdgesTested;
+
+					// Outside the band, pixels within the search range of the first pixel can't have an edge between them, so are on the same side of it
+					bool outside = firstOutside;
+					if(channel.SignRaster)
+						outside = channel.SignRaster->IsOutside(packet.Pixels[p].X, packet.Pixels[p].Y);
+					else if(inBand || p == 0 || FVector2f::DistSquared(packet.SourcePositions[p], packet.SourcePositions[0]) > FMath::Square(range.SearchRange))
+						outside = ComputePixelValue<TFormat>(packet.SourcePositions[p], channel.SourceBuffer, channel.SourceBufferDef, channel.Mapping.SourceChannel) < TFormat::FTraits::Threshold;
+
+					if(p == 0)
+						firstOutside = outside;
+
+					const float dist = FMath::Sqrt(search.ClosestDistanceSq);
+					const float signedDist = (outside ^ channel.Mapping.bInvertDistance) ? dist : -dist;
+					const float distN = signedDist / range.SearchRange + 0.5f;
+					const size_t sdfPixelIdx = (static_cast<size_t>(packet.Pixels[p].Y) * sdfBufferDef.Width + packet.Pixels[p].X) * sdfBufferDef.NumChannels + channel.Mapping.TargetChannel;
+					WriteDistance(outSDFBuffer, sdfBufferDef, sdfPixelIdx, distN >= range.HalfFieldDistance ? 1.0f : distN);
 				}
+
+				numCellsVisited += packetCellsVisited;
+				numEdgesTested += packetEdgesTested;
+			};
+
+			// Tiles entirely outside the narrow band have no edges in range of, or between, any of their pixels. Every pixel is on the same side, and keeps the distance a search would start and end with
+			// so the whole tile is filled with that one value, without building any packets
+			auto fillTileOutsideBand = [&](const int channelIdx, const FIntRect& tileRect)
+			{
+				const FDistanceFieldChannel<TEdgeSearch, TFormat>& channel = channels[channelIdx];
+				const FChannelSearchRange& range = channelRanges[channelIdx];
+				if(!channel.NarrowBand)
+					return false;
+
+				auto sourcePos = [&](const FIntPoint& pixel) { return TransformPos(sdfBufferDef, channel.MappedBufferDef, FVector2f(pixel), channel.Mapping.Scale) - FVector2f(channel.SourceOrigin); };
+				const FVector2f minPos = sourcePos(tileRect.Min);
+				const FVector2f maxPos = sourcePos(tileRect.Max - FIntPoint(1, 1));
+				if(range.SearchZones.ContainsByPredicate([&](const FVector2f& zone) { return channel.NarrowBand->IsAnyInBand(minPos + zone * range.ZoneOffset, maxPos + zone * range.ZoneOffset); }))
+					return false;
+
+				const bool outside = channel.SignRaster
+					? channel.SignRaster->IsOutside(tileRect.Min.X, tileRect.Min.Y)
+					: ComputePixelValue<TFormat>(minPos, channel.SourceBuffer, channel.SourceBufferDef, channel.Mapping.SourceChannel) < TFormat::FTraits::Threshold;
+
+				// The same arithmetic as a skipped search, so filled pixels are identical to those of skipped packets
+				const FSearchContext unsearched(minPos, range.HalfFieldDistance);
+				const float dist = FMath::Sqrt(unsearched.ClosestDistanceSq);
+				const float signedDist = (outside ^ channel.Mapping.bInvertDistance) ? dist : -dist;
+				const float distN = signedDist / range.SearchRange + 0.5f;
+				FillDistance(outSDFBuffer, sdfBufferDef, tileRect, channel.Mapping.TargetChannel, distN >= range.HalfFieldDistance ? 1.0f : distN);
+
+				numSkippedPixels += tileRect.Area();
+				return true;
+			};
+
+			// Square tiles of packets are dispatched in Morton order, so the consecutive tasks that each worker picks up search the same region of the edges
+			// Within a tile, each row of packets is searched in order, seeding each search from the packet to its left
+			const int tilePackets = FMath::Max(searchTileSize / TREESEARCH_PACKET_SIZE, 1);
+			const int numTilesX = FMath::DivideAndRoundUp(numPacketsX, tilePackets);
+			const int numTilesY = FMath::DivideAndRoundUp(numPacketsY, tilePackets);
+			TArray<FIntPoint> tiles;
+			tiles.Reserve(numTilesX * numTilesY);
+			for(int tileY = 0; tileY < numTilesY; ++tileY)
+			{
+				for(int tileX = 0; tileX < numTilesX; ++tileX)
+					tiles.Add(FIntPoint(tileX, tileY));
 			}
+
+			auto mortonCode = [](const FIntPoint& tile) { return FMath::MortonCode2(tile.X) | (FMath::MortonCode2(tile.Y) << 1); };
+			tiles.Sort([&mortonCode](const FIntPoint& a, const FIntPoint& b) { return mortonCode(a) < mortonCode(b); });
+
+			ParallelFor(channels.Num() * tiles.Num(), [&](const int taskIdx)
+			{
+				const int channelIdx = taskIdx / tiles.Num();
+				const FIntPoint& tile = tiles[taskIdx % tiles.Num()];
+				const int packetColStart = tile.X * tilePackets;
+				const int packetColEnd = FMath::Min(packetColStart + tilePackets, numPacketsX);
+				const int packetRowEnd = FMath::Min((tile.Y + 1) * tilePackets, numPacketsY);
+
+				const FIntPoint tileMin(sdfRect.Min.X + packetColStart * TREESEARCH_PACKET_SIZE, sdfRect.Min.Y + tile.Y * tilePackets * TREESEARCH_PACKET_SIZE);
+				const FIntPoint tileMax(FMath::Min(sdfRect.Min.X + packetColEnd * TREESEARCH_PACKET_SIZE, sdfRect.Max.X), FMath::Min(sdfRect.Min.Y + packetRowEnd * TREESEARCH_PACKET_SIZE, sdfRect.Max.Y));
+				if(fillTileOutsideBand(channelIdx, FIntRect(tileMin, tileMax)))
+					return;
+
+				FSearchPacket packets[2];
+				for(int packetRow = tile.Y * tilePackets; packetRow < packetRowEnd; ++packetRow)
+				{
+					for(int packetCol = packetColStart; packetCol < packetColEnd; ++packetCol)
+					{
+						const int tileCol = packetCol - packetColStart;
+						const FSearchPacket* seedPacket = tileCol > 0 ? &packets[(tileCol - 1) & 1] : nullptr;
+						searchPacket(channelIdx, sdfRect.Min.X + packetCol * TREESEARCH_PACKET_SIZE, sdfRect.Min.Y + packetRow * TREESEARCH_PACKET_SIZE, packets[tileCol & 1], seedPacket);
+					}
+				}
+			});
+
+			const uint64 cyclesEnd = FPlatformTime::Cycles();
+			const uint64 numPixels = static_cast<uint64>(sdfRect.Width()) * sdfRect.Height() * channels.Num();
+			UE_LOG(RTMSDF, Verbose, TEXT("Populated Distance Field %llu pixels in %d channels, %d tiles of %d pixels (%.2fms)"), numPixels, channels.Num(), tiles.Num(), tilePackets * TREESEARCH_PACKET_SIZE, FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+			UE_LOG(RTMSDF, Verbose, TEXT("Cells/Edges visited %llu/%llu (%.1f/%.1f per pixel)"), numCellsVisited.load(), numEdgesTested.load(), static_cast<double>(numCellsVisited) / numPixels, static_cast<double>(numEdgesTested) / numPixels);
+			UE_LOG(RTMSDF, Verbose, TEXT("Skipped %llu pixels outside the narrow band (%.1f%%)"), numSkippedPixels.load(), numSkippedPixels * 100.0 / numPixels);
 		}
 
-		const uint64 cyclesEnd = FPlatformTime::Cycles();
-		const int numEdges = tree.Edges.Num();
-		UE_LOG(RTMSDF, Verbose, TEXT("Num Edges/Cells %d/%d (%.2fms)"), numEdges, tree.Cells.Num(), FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
-		UE_LOG(RTMSDF, VeryVerbose, TEXT("%s"), *tree.ToString());
+		template<typename TEdgeSearch, typename TFormat>
+		static void FindDistances(const TEdgeSearch& edgeSearch, const typename TFormat::TChannel* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping, int searchTileSize)
+		{
+			const TArray<FDistanceFieldChannel<TEdgeSearch, TFormat>> channels = {{&edgeSearch, sourceBuffer, sourceBufferDef, mapping, sourceBufferDef}};
+			FindDistances(channels, outSDFBuffer, sdfBufferDef, FIntRect(0, 0, sdfBufferDef.Width, sdfBufferDef.Height), searchTileSize);
+		}
 
-		return numEdges > 0;
-	}
+		/* Builds a TEdgeSearch from each plane's edges with populateFunc, then searches all channels together
+		 * Signs are rasterized from the edges if rasterizeSigns, which needs them to form closed contours, otherwise each pixel samples the source */
+		template<typename TEdgeSearch, typename TChannel, typename TPopulateFunc>
+		static void FindDistances(const TArray<const TChannel*>& planeBuffers, const FSDFBufferDef& planeBufferDef, const FSDFBufferDef& sourceBufferDef, const FIntRect& sourceRect, const TArray<TArray<FVector2f>>& planeEdgePoints, const TArray<int>& channelPlanes, const TArray<FSDFBufferMapping>& channelMappings, bool skipEmptyPlanes, bool rasterizeSigns, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FIntRect& sdfRect, int searchTileSize, TPopulateFunc&& populateFunc)
+		{
+			TArray<TUniquePtr<TEdgeSearch>> planeSearches;
+			planeSearches.SetNum(planeBuffers.Num());
 
-	void FindDistances(const FQuadTree& tree, const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping)
-	{
-		const uint64 cyclesStart = FPlatformTime::Cycles();
+			// Each plane's narrow band must cover the widest range of any channel generated from it
+			TArray<float> planeBandDistances;
+			planeBandDistances.Init(0.0f, planeBuffers.Num());
+			for(int i = 0; i < channelMappings.Num(); ++i)
+				planeBandDistances[channelPlanes[i]] = FMath::Max(planeBandDistances[channelPlanes[i]], FChannelSearchRange(sourceBufferDef, channelMappings[i]).HalfFieldDistance);
 
-		const float halfFieldDistance = mapping.DistanceRangeNormalized * FMath::Min(sourceBufferDef.Width, sourceBufferDef.Height) * mapping.Scale;
-		const float searchRange = halfFieldDistance * 2.0f;
+			TArray<TUniquePtr<FNarrowBand>> planeBands;
+			planeBands.SetNum(planeBuffers.Num());
 
-		TArray<FVector2f> searchZones = {{0.0f, 0.0f}};
-		if(mapping.bTileX)
-			searchZones.Append({{-1.0f, 0.0f}, {1.0f, 0.0f}});
+			// Signs only depend on the plane and how output pixels map onto it, so channels that share both share a raster
+			struct FPlaneSignRaster
+			{
+				int Plane = 0;
+				float Scale = 1.0f;
+				TUniquePtr<FSignRaster> Raster;
+			};
+			TArray<FPlaneSignRaster> signRasters;
 
-		if(mapping.bTileY)
-			searchZones.Append({{0.0f, -1.0f}, {0.0f, 1.0f}});
+			TArray<FDistanceFieldChannel<TEdgeSearch, TPixelFormat<TChannel, 1>>> channels;
+			for(int i = 0; i < channelMappings.Num(); ++i)
+			{
+				const int plane = channelPlanes[i];
+				if(skipEmptyPlanes && planeEdgePoints[plane].Num() == 0)
+					continue;
 
-		if(mapping.bTileX && mapping.bTileY)
-			searchZones.Append({{-1.0f, -1.0f}, {1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f}});
+				if(!planeSearches[plane].IsValid())
+				{
+					planeSearches[plane] = populateFunc(planeEdgePoints[plane]);
+					planeBands[plane] = MakeUnique<FNarrowBand>(planeEdgePoints[plane], planeBufferDef, planeBandDistances[plane]);
+				}
 
-		FVector2f zoneOffset = FVector2f(sourceBufferDef.Width, sourceBufferDef.Height) * mapping.Scale;
+				const float scale = channelMappings[i].Scale;
+				FPlaneSignRaster* signRaster = signRasters.FindByPredicate([plane, scale](const FPlaneSignRaster& raster) { return raster.Plane == plane && raster.Scale == scale; });
+				if(!signRaster && rasterizeSigns)
+				{
+					signRaster = &signRasters.AddDefaulted_GetRef();
+					signRaster->Plane = plane;
+					signRaster->Scale = scale;
+					signRaster->Raster = MakeUnique<FSignRaster>(planeEdgePoints[plane], planeBuffers[plane], planeBufferDef, 0, sourceBufferDef, sourceRect.Min, sdfBufferDef, sdfRect, scale);
+				}
+
+				channels.Add({planeSearches[plane].Get(), planeBuffers[plane], planeBufferDef, channelMappings[i], sourceBufferDef, sourceRect.Min, planeBands[plane].Get(), signRaster ? signRaster->Raster.Get() : nullptr});
+			}
+
+			FindDistances(channels, outSDFBuffer, sdfBufferDef, sdfRect, searchTileSize);
+		}
 
-		// NOTE - seems to be little to no difference to splitting threads by rows or pixels
-#if TREESEARCH_THREAD_ROWS
-		ParallelFor(sdfBufferDef.Height, [&](const int y)
+		template<typename TFormat>
+		static void FindEdges(const TArray<const typename TFormat::TChannel*>& sourceBuffers, const FSDFBufferDef& sourceBufferDef, int channelOffset, bool antiAliased, TArray<TArray<FVector2f>>& outEdgePoints)
 		{
-			for(int x = 0; x<sdfBufferDef.Width; ++x)
+			const uint64 cyclesStart = FPlatformTime::Cycles();
+
+			// Each band of rows collects its own edges, then the bands are appended in order, so the edge order matches a serial pass over the source
+			constexpr int rowsPerBand = 16;
+			const int numBands = FMath::DivideAndRoundUp(sourceBufferDef.Height, rowsPerBand);
+			const int numSources = sourceBuffers.Num();
+			TArray<TArray<FVector2f>> bandEdgePoints;
+			bandEdgePoints.SetNum(numBands * numSources);
+
+			ParallelFor(numBands, [&](const int band)
+			{
+				const int bandEnd = FMath::Min((band + 1) * rowsPerBand, sourceBufferDef.Height);
+				FCoverageRowScratch coverageScratch;
+				for(int source = 0; source < numSources; ++source)
+				{
+					coverageScratch.NextRowY = INDEX_NONE;
+					for(int y = band * rowsPerBand; y < bandEnd; ++y)
+					{
+						if(antiAliased)
+							FindRowCoverageEdges<TFormat>(sourceBuffers[source], sourceBufferDef, channelOffset, y, coverageScratch, bandEdgePoints[band * numSources + source]);
+						else
+							FindRowEdges<TFormat>(sourceBuffers[source], sourceBufferDef, channelOffset, y, bandEdgePoints[band * numSources + source]);
+					}
+				}
+			});
+
+			outEdgePoints.SetNum(numSources);
+			for(int source = 0; source < numSources; ++source)
 			{
-				const int i = y * sdfBufferDef.Width + x;
-				const FVector2f sdfPos(x, y);
-#else
-		ParallelFor(sdfBufferDef.Width * sdfBufferDef.Height, [&](const int i)
+				int numEdgePoints = 0;
+				for(int band = 0; band < numBands; ++band)
+					numEdgePoints += bandEdgePoints[band * numSources + source].Num();
+
+				outEdgePoints[source].Reset(numEdgePoints);
+				for(int band = 0; band < numBands; ++band)
+					outEdgePoints[source].Append(bandEdgePoints[band * numSources + source]);
+			}
+
+			const uint64 cyclesEnd = FPlatformTime::Cycles();
+			for(int source = 0; source < numSources; ++source)
+				UE_LOG(RTMSDF, Verbose, TEXT("Num Edges[%d] = %d"), source, outEdgePoints[source].Num() / 2);
+			UE_LOG(RTMSDF, Verbose, TEXT("Found edges in %d channels (%.2fms)"), numSources, FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+		}
+
+		/* Chains edges that share end points into polylines, then simplifies each with Douglas-Peucker, so that no point on the original edges is further than tolerance from the simplified ones
+		 * Only points shared by exactly two edges are chained through, so saddles are kept as they were. Closed polylines end on their first point */
+		static void TraceContours(const TArray<FVector2f>& edgePoints, float tolerance, TArray<TArray<FVector2f>>& outPolylines)
 		{
+			// Neighbouring cells find their shared intersections from the same two pixels, so shared end points are bitwise identical
+			const int32 numEdges = edgePoints.Num() / 2;
+			TMap<FVector2f, TArray<int32, TInlineAllocator<2>>> pointEdges;
+			pointEdges.Reserve(numEdges);
+			for(int32 i = 0; i < numEdges * 2; ++i)
+				pointEdges.FindOrAdd(edgePoints[i]).Add(i / 2);
+
+			auto nextEdge = [&pointEdges](const FVector2f& point, int32 fromEdge)
 			{
-				const FVector2f sdfPos(i % sdfBufferDef.Width, i / sdfBufferDef.Width);
-#endif
-				const FVector2f sourcePos = Internal::TransformPos(sdfBufferDef, sourceBufferDef, sdfPos, mapping.Scale);
+				const auto& edges = pointEdges.FindChecked(point);
+				return edges.Num() != 2 ? INDEX_NONE : edges[0] == fromEdge ? edges[1] : edges[0];
+			};
+
+			auto otherEnd = [&edgePoints](int32 edge, const FVector2f& point)
+			{
+				return edgePoints[edge * 2] == point ? edgePoints[edge * 2 + 1] : edgePoints[edge * 2];
+			};
+
+			outPolylines.Reset();
+			TBitArray<> visited(false, numEdges);
+			TArray<FVector2f> polyline;
+			TArray<bool> keepPoints;
+			TArray<FIntPoint> spans;
+			for(int32 e = 0; e < numEdges; ++e)
+			{
+				if(visited[e])
+					continue;
+
+				// Walk back to the open end of the chain, or all the way around a closed loop
+				int32 startEdge = e;
+				FVector2f startPoint = edgePoints[e * 2];
+				for(int32 prevEdge = nextEdge(startPoint, startEdge); prevEdge != INDEX_NONE && prevEdge != e; prevEdge = nextEdge(startPoint, startEdge))
+				{
+					startPoint = otherEnd(prevEdge, startPoint);
+					startEdge = prevEdge;
+				}
+
+				polyline.Reset();
+				polyline.Add(startPoint);
+				FVector2f point = startPoint;
+				for(int32 edge = startEdge; edge != INDEX_NONE && !visited[edge]; edge = nextEdge(point, edge))
+				{
+					visited[edge] = true;
+					point = otherEnd(edge, point);
+					polyline.Add(point);
+				}
+
+				// Closed loops start and end on the same point, which Douglas-Peucker handles as a zero length segment
+				keepPoints.Reset();
+				keepPoints.SetNumZeroed(polyline.Num());
+				keepPoints[0] = true;
+				keepPoints.Last() = true;
+
+				spans.Reset();
+				spans.Add(FIntPoint(0, polyline.Num() - 1));
+				while(spans.Num() > 0)
+				{
+					const FIntPoint span = spans.Pop();
+					float farthestDistanceSq = FMath::Square(tolerance);
+					int32 farthest = INDEX_NONE;
+					for(int32 i = span.X + 1; i < span.Y; ++i)
+					{
+						const float distanceSq = FVector2f::DistSquared(polyline[i], Utils::ClosestPointOnSegment2D(polyline[i], polyline[span.X], polyline[span.Y]));
+						if(distanceSq > farthestDistanceSq)
+						{
+							farthestDistanceSq = distanceSq;
+							farthest = i;
+						}
+					}
+
+					if(farthest != INDEX_NONE)
+					{
+						keepPoints[farthest] = true;
+						spans.Add(FIntPoint(span.X, farthest));
+						spans.Add(FIntPoint(farthest, span.Y));
+					}
+				}
+
+				TArray<FVector2f>& simplified = outPolylines.AddDefaulted_GetRef();
+				for(int32 i = 0; i < polyline.Num(); ++i)
+				{
+					if(keepPoints[i])
+						simplified.Add(polyline[i]);
+				}
+			}
+		}
+
+		static void SimplifyEdges(const TArray<FVector2f>& edgePoints, float tolerance, TArray<FVector2f>& outEdgePoints)
+		{
+			const uint64 cyclesStart = FPlatformTime::Cycles();
+
+			TArray<TArray<FVector2f>> polylines;
+			TraceContours(edgePoints, tolerance, polylines);
+
+			outEdgePoints.Reset();
+			for(const TArray<FVector2f>& polyline : polylines)
+			{
+				for(int32 i = 1; i < polyline.Num(); ++i)
+				{
+					outEdgePoints.Add(polyline[i - 1]);
+					outEdgePoints.Add(polyline[i]);
+				}
+			}
+
+			const int32 numEdges = edgePoints.Num() / 2;
+			const uint64 cyclesEnd = FPlatformTime::Cycles();
+			UE_LOG(RTMSDF, Verbose, TEXT("Simplified %d edges to %d (%.2fms)"), numEdges, outEdgePoints.Num() / 2, FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+		}
+
+		static bool IsSameSearch(const FSDFBufferMapping& a, const FSDFBufferMapping& b)
+		{
+			return a.bInvertDistance == b.bInvertDistance
+				&& a.bTileX == b.bTileX
+				&& a.bTileY == b.bTileY
+				&& a.DistanceRangeNormalized == b.DistanceRangeNormalized
+				&& a.Scale == b.Scale;
+		}
+
+		// Region of the source that contains every edge in range of the output pixels in sdfRect, plus the marching squares / bilinear sample footprint. Wrapped axes extend past the edges of the source
+		static FIntRect FindSourceRect(const FIntRect& sdfRect, const FSDFBufferDef& sdfBufferDef, const FSDFBufferDef& sourceBufferDef, const TArray<FSDFBufferMapping>& mappings, int halo, bool wrapX, bool wrapY)
+		{
+			FVector2f sourceMin(FLT_MAX);
+			FVector2f sourceMax(-FLT_MAX);
+			for(const FSDFBufferMapping& mapping : mappings)
+			{
+				for(const FIntPoint& corner : {sdfRect.Min, sdfRect.Max - FIntPoint(1, 1)})
+				{
+					const FVector2f cornerPos = TransformPos(sdfBufferDef, sourceBufferDef, FVector2f(corner), mapping.Scale);
+					sourceMin = FVector2f::Min(sourceMin, cornerPos);
+					sourceMax = FVector2f::Max(sourceMax, cornerPos);
+				}
+			}
+
+			FIntRect sourceRect(FMath::FloorToInt(sourceMin.X) - halo, FMath::FloorToInt(sourceMin.Y) - halo, FMath::CeilToInt(sourceMax.X) + halo + 1, FMath::CeilToInt(sourceMax.Y) + halo + 1);
+			if(!wrapX)
+			{
+				sourceRect.Min.X = FMath::Clamp(sourceRect.Min.X, 0, sourceBufferDef.Width - 1);
+				sourceRect.Max.X = FMath::Clamp(sourceRect.Max.X, sourceRect.Min.X + 1, sourceBufferDef.Width);
+			}
+			if(!wrapY)
+			{
+				sourceRect.Min.Y = FMath::Clamp(sourceRect.Min.Y, 0, sourceBufferDef.Height - 1);
+				sourceRect.Max.Y = FMath::Clamp(sourceRect.Max.Y, sourceRect.Min.Y + 1, sourceBufferDef.Height);
+			}
+
+			return sourceRect;
+		}
+
+		/* Generates the sdfRect region of the output from the sourceRect region of the source. sourceRect may extend past the edges of the source, which wrap
+		 * Planes without edges are skipped if skipEmptyChannels, otherwise they are filled with the distance at the edge of the range */
+		template<typename TFormat>
+		static bool CreateDistanceFields(const typename TFormat::TChannel* sourceBuffer, const FSDFBufferDef& sourceBufferDef, const FIntRect& sourceRect, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FIntRect& sdfRect, const TArray<FSDFBufferMapping>& mappings, ERTMSDF_BitmapDistanceEngine engine, bool skipEmptyChannels, int searchTileSize, float edgeTolerance, TArray<bool>& outSuccess)
+		{
+			const uint64 cyclesStart = FPlatformTime::Cycles();
+
+			outSuccess.Init(false, mappings.Num());
+
+			// De-interleave every source channel in use into its own plane, in a single pass over the source rect
+			TArray<uint8> sourceChannels;
+			for(const FSDFBufferMapping& mapping : mappings)
+				sourceChannels.AddUnique(mapping.SourceChannel);
+
+			// Planes keep the source's channel type, so no precision is lost and each kernel below is compiled for it with a fixed stride
+			using TChannel = typename TFormat::TChannel;
+			using FPlaneFormat = TPixelFormat<TChannel, 1>;
+			const FSDFBufferDef planeBufferDef(sourceRect.Width(), sourceRect.Height(), 1);
+			const size_t planeLen = planeBufferDef.GetBufferLen();
+			TChannel* const planes = static_cast<TChannel*>(FMemory::Malloc(planeLen * sizeof(TChannel) * sourceChannels.Num()));
+			ON_SCOPE_EXIT { FMemory::Free(planes); };
+
+			auto wrap = [](int value, int size) { return ((value % size) + size) % size; };
+			ParallelFor(planeBufferDef.Height, [&](const int y)
+			{
+				const int sourceY = wrap(sourceRect.Min.Y + y, sourceBufferDef.Height);
+				for(int x = 0; x < planeBufferDef.Width; ++x)
+				{
+					const size_t pixelIdx = static_cast<size_t>(y) * planeBufferDef.Width + x;
+					const size_t sourcePixelIdx = static_cast<size_t>(sourceY) * sourceBufferDef.Width + wrap(sourceRect.Min.X + x, sourceBufferDef.Width);
+					for(int plane = 0; plane < sourceChannels.Num(); ++plane)
+						planes[planeLen * plane + pixelIdx] = sourceBuffer[sourcePixelIdx * TFormat::NumChannels + sourceChannels[plane]];
+				}
+			});
+
+			// Channels with identical contents (e.g. greyscale RGB masks) share a plane, so their edges and searches are only computed once
+			TArray<const TChannel*> uniquePlanes;
+			TArray<int> sourceChannelPlanes;
+			for(int plane = 0; plane < sourceChannels.Num(); ++plane)
+			{
+				const TChannel* planeBuffer = planes + planeLen * plane;
+				int uniquePlane = uniquePlanes.IndexOfByPredicate([planeBuffer, planeLen](const TChannel* other) { return FMemory::Memcmp(planeBuffer, other, planeLen * sizeof(TChannel)) == 0; });
+				if(uniquePlane == INDEX_NONE)
+					uniquePlane = uniquePlanes.Add(planeBuffer);
+
+				sourceChannelPlanes.Add(uniquePlane);
+			}
+
+			// Mappings of the same plane with the same settings produce identical output, so only the first is generated and the rest copy it
+			TArray<FSDFBufferMapping> channelMappings;
+			TArray<int> channelPlanes;
+			TArray<int> mappingChannels;
+			for(const FSDFBufferMapping& mapping : mappings)
+			{
+				const int plane = sourceChannelPlanes[sourceChannels.Find(mapping.SourceChannel)];
+				int channel = INDEX_NONE;
+				for(int i = 0; i < channelMappings.Num() && channel == INDEX_NONE; ++i)
+				{
+					if(channelPlanes[i] == plane && IsSameSearch(channelMappings[i], mapping))
+						channel = i;
+				}
+
+				if(channel == INDEX_NONE)
+				{
+					FSDFBufferMapping& channelMapping = channelMappings.Add_GetRef(mapping);
+					channelMapping.SourceChannel = 0;
+					channel = channelPlanes.Add(plane);
+				}
+
+				mappingChannels.Add(channel);
+			}
+
+			// Anti-aliased edges are separate pieces of each pixel's tangent rather than closed contours, so can't be used to rasterize signs
+			const bool antiAliased = engine == ERTMSDF_BitmapDistanceEngine::AntiAliasedDistanceTransform;
+			TArray<TArray<FVector2f>> planeEdgePoints;
+			FindEdges<FPlaneFormat>(uniquePlanes, planeBufferDef, 0, antiAliased, planeEdgePoints);
+
+			switch(engine)
+			{
+				case ERTMSDF_BitmapDistanceEngine::DistanceTransform:
+				case ERTMSDF_BitmapDistanceEngine::AntiAliasedDistanceTransform:
+					FindDistances<FDistanceTransform>(uniquePlanes, planeBufferDef, sourceBufferDef, sourceRect, planeEdgePoints, channelPlanes, channelMappings, skipEmptyChannels, !antiAliased, outSDFBuffer, sdfBufferDef, sdfRect, searchTileSize, [&planeBufferDef](const TArray<FVector2f>& edgePoints)
+					{
+						auto distanceTransform = MakeUnique<FDistanceTransform>(planeBufferDef.Width, planeBufferDef.Height, edgePoints.Num() / 2);
+						PopulateDistanceTransform(edgePoints, *distanceTransform);
+						return distanceTransform;
+					});
+					break;
+
+				case ERTMSDF_BitmapDistanceEngine::EdgeTree:
+					FindDistances<FQuadTree>(uniquePlanes, planeBufferDef, sourceBufferDef, sourceRect, planeEdgePoints, channelPlanes, channelMappings, skipEmptyChannels, true, outSDFBuffer, sdfBufferDef, sdfRect, searchTileSize, [&planeBufferDef, edgeTolerance](const TArray<FVector2f>& edgePoints)
+					{
+						// Only the tree's edges are simplified. The narrow band and signs still use the original edges, which stay within a single source pixel
+						TArray<FVector2f> simplifiedPoints;
+						if(edgeTolerance > 0.0f)
+							SimplifyEdges(edgePoints, edgeTolerance, simplifiedPoints);
+
+						const TArray<FVector2f>& treePoints = edgeTolerance > 0.0f ? simplifiedPoints : edgePoints;
+						const int numEdges = treePoints.Num() / 2;
+						auto tree = MakeUnique<FQuadTree>(planeBufferDef.Width, planeBufferDef.Height, numEdges, numEdges * 2);
+						PopulateEdgeTree(treePoints, *tree);
+						return tree;
+					});
+					break;
+
+				default:
+					static_assert(static_cast<int>(ERTMSDF_BitmapDistanceEngine::MAX) == 3);
+					const int enumIntValue = static_cast<int>(engine);
+					const auto* uenumPtr = StaticEnum<ERTMSDF_BitmapDistanceEngine>();
+					const FString enumName = uenumPtr->GetNameStringByValue(enumIntValue);
+					ensureAlwaysMsgf(false, TEXT("Unknown distance engine requested ('%s' - %d)- skipping"), *enumName, enumIntValue);
+					return false;
+			}
+
+			bool anySuccess = false;
+			for(int i = 0; i < mappings.Num(); ++i)
+			{
+				const int channel = mappingChannels[i];
+				outSuccess[i] = planeEdgePoints[channelPlanes[channel]].Num() > 0;
+				anySuccess |= outSuccess[i];
+
+				const uint8 generatedTarget = channelMappings[channel].TargetChannel;
+				const uint8 target = mappings[i].TargetChannel;
+				if((outSuccess[i] || !skipEmptyChannels) && generatedTarget != target)
+				{
+					const int bytesPerChannel = GetBytesPerChannel(sdfBufferDef);
+					for(int y = sdfRect.Min.Y; y < sdfRect.Max.Y; ++y)
+					{
+						for(int x = sdfRect.Min.X; x < sdfRect.Max.X; ++x)
+						{
+							const size_t pixelIdx = (static_cast<size_t>(y) * sdfBufferDef.Width + x) * sdfBufferDef.NumChannels;
+							FMemory::Memcpy(outSDFBuffer + (pixelIdx + target) * bytesPerChannel, outSDFBuffer + (pixelIdx + generatedTarget) * bytesPerChannel, bytesPerChannel);
+						}
+					}
+				}
+			}
+
+			const uint64 cyclesEnd = FPlatformTime::Cycles();
+			UE_LOG(RTMSDF, Verbose, TEXT("Generated %d channels from %d unique channels (%.2fms)"), mappings.Num(), channelMappings.Num(), FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+			return anySuccess;
+		}
+	}
+
+	void SetChannelUniformValue(uint8* buffer, const FSDFBufferDef& bufferDef, uint8 channelOffset, uint8 value)
+	{
+		const size_t bufferLen = bufferDef.GetBufferLen();
+		if(GetBytesPerChannel(bufferDef) == 1)
+		{
+			for(size_t i = 0; i < bufferLen; i += bufferDef.NumChannels)
+				buffer[i + channelOffset] = value;
+
+			return;
+		}
+
+		// Values are 8 bit, so are scaled to the range of wider buffers
+		const bool supported = VisitPixelFormat(bufferDef, [&](auto format)
+		{
+			using TFormat = decltype(format);
+			const typename TFormat::TChannel typedValue = TFormat::FTraits::FromUnit(value / 255.0f);
+			auto* typedBuffer = reinterpret_cast<typename TFormat::TChannel*>(buffer);
+			for(size_t i = 0; i < bufferLen; i += bufferDef.NumChannels)
+				typedBuffer[i + channelOffset] = typedValue;
+		});
 
-				FSearchContext search(sourcePos, halfFieldDistance);
+		ensureAlwaysMsgf(supported, TEXT("Unsupported buffer format (ETextureSourceFormat = %d) - channel not set"), static_cast<int>(bufferDef.Format));
+	}
+
+	void CopyChannelValues(uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8 sourceChannelOffset, uint8* targetBuffer, const FSDFBufferDef& targetBufferDef, uint8 targetChannelOffset)
+	{
+		check(sourceBufferDef.Width == targetBufferDef.Width);
+		check(sourceBufferDef.Height == targetBufferDef.Height);
+		const size_t numPixels = static_cast<size_t>(sourceBufferDef.Width) * sourceBufferDef.Height;
+		const bool supported = VisitPixelFormat(sourceBufferDef, [&](auto format)
+		{
+			// Targets are always 8 bit, so wider sources are rounded to the nearest 8 bit value
+			using TFormat = decltype(format);
+			const auto* typedSource = reinterpret_cast<const typename TFormat::TChannel*>(sourceBuffer);
+			for(size_t i = 0; i < numPixels; ++i)
+			{
+				const typename TFormat::TChannel value = typedSource[i * TFormat::NumChannels + sourceChannelOffset];
+				if constexpr(std::is_same_v<typename TFormat::TChannel, uint8>)
+					targetBuffer[i * targetBufferDef.NumChannels + targetChannelOffset] = value;
+				else
+					targetBuffer[i * targetBufferDef.NumChannels + targetChannelOffset] = static_cast<uint8>(FMath::RoundToInt(TFormat::ToUnit(value) * 255.0f));
+			}
+		});
+
+		ensureAlwaysMsgf(supported, TEXT("Unsupported source format (ETextureSourceFormat = %d) - channel not copied"), static_cast<int>(sourceBufferDef.Format));
+	}
+
+	// The fastest search tile size depends on the machine's caches and core count, so the first call times each candidate on a synthetic source
+	// Generation never calls this itself, so only callers that ask for it pay for the benchmark. The editor runs it on the first bitmap import
+	int FindBestSearchTileSize()
+	{
+		static const int bestTileSize = []()
+		{
+			const uint64 cyclesStart = FPlatformTime::Cycles();
+
+			// Rings that narrow towards the edge of the source give a mix of sparse and dense edges
+			constexpr int sourceSize = 512;
+			const FSDFBufferDef bufferDef(sourceSize, sourceSize, 1);
+			const FIntRect bounds(0, 0, sourceSize, sourceSize);
+			TArray<uint8> source;
+			source.SetNumUninitialized(sourceSize * sourceSize);
+			for(int y = 0; y < sourceSize; ++y)
+			{
+				for(int x = 0; x < sourceSize; ++x)
+				{
+					const float radiusSq = FVector2f::DistSquared(FVector2f(x, y), FVector2f(sourceSize * 0.5f));
+					source[y * sourceSize + x] = FMath::Sin(radiusSq * 0.0005f) > 0.0f ? 255 : 0;
+				}
+			}
+
+			TArray<uint8> sdf;
+			sdf.SetNumUninitialized(sourceSize * sourceSize);
+			const TArray<FSDFBufferMapping> mappings = {FSDFBufferMapping(0, 0, 0.05f)};
+
+			int bestCandidate = 0;
+			double bestMilliseconds = DBL_MAX;
+			for(const int candidate : {8, 16, 32, 64, 128})
+			{
+				// Best of two runs, so the first candidate isn't penalised for warming the caches and worker threads
+				double candidateMilliseconds = DBL_MAX;
+				for(int run = 0; run < 2; ++run)
+				{
+					TArray<bool> success;
+					const uint64 cyclesRunStart = FPlatformTime::Cycles();
+					Internal::CreateDistanceFields<FPixelFormatG8>(source.GetData(), bufferDef, bounds, sdf.GetData(), bufferDef, bounds, mappings, ERTMSDF_BitmapDistanceEngine::EdgeTree, true, candidate, 0.0f, success);
+					candidateMilliseconds = FMath::Min(candidateMilliseconds, FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles() - cyclesRunStart));
+				}
 
-				for(auto& zone : searchZones)
+				UE_LOG(RTMSDF, Verbose, TEXT("Search tile size %d: %.2fms"), candidate, candidateMilliseconds);
+				if(candidateMilliseconds < bestMilliseconds)
 				{
-					search = FSearchContext(sourcePos + zone * zoneOffset, FMath::Sqrt(search.ClosestDistanceSq));
-					tree.FindDistance(search);
+					bestMilliseconds = candidateMilliseconds;
+					bestCandidate = candidate;
 				}
+			}
+
+			const uint64 cyclesEnd = FPlatformTime::Cycles();
+			UE_LOG(RTMSDF, Log, TEXT("Picked a bitmap search tile size of %d pixels (%.2fms)"), bestCandidate, FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+			return bestCandidate;
+		}();
+
+		return bestTileSize;
+	}
+
+	bool CreateDistanceField(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping, ERTMSDF_BitmapDistanceEngine engine)
+	{
+		TArray<bool> success;
+		CreateDistanceFields(sourceBuffer, sourceBufferDef, outSDFBuffer, sdfBufferDef, {mapping}, engine, success);
+		return success[0];
+	}
+
+	bool CreateDistanceFields(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const TArray<FSDFBufferMapping>& mappings, ERTMSDF_BitmapDistanceEngine engine, TArray<bool>& outSuccess, int tileSize, int searchTileSize, float edgeTolerance)
+	{
+		if(searchTileSize <= 0)
+			searchTileSize = TREESEARCH_DEFAULT_TILE_SIZE;
+
+		// Wrapping is handled by a halo around the source that reads from its other side. Edges across the seams and in range of the far side are then found like any other, so the wrapped search zones aren't needed
+		float maxHalfFieldDistance = 0.0f;
+		bool wrapX = false;
+		bool wrapY = false;
+		TArray<FSDFBufferMapping> searchMappings = mappings;
+		for(FSDFBufferMapping& mapping : searchMappings)
+		{
+			maxHalfFieldDistance = FMath::Max(maxHalfFieldDistance, Internal::FChannelSearchRange(sourceBufferDef, mapping).HalfFieldDistance);
+			wrapX |= mapping.bTileX;
+			wrapY |= mapping.bTileY;
+			mapping.bTileX = false;
+			mapping.bTileY = false;
+		}
+		const int halo = FMath::CeilToInt(maxHalfFieldDistance) + 2;
+
+		// Each supported source format has its own compiled generation, with fixed channel strides
+		auto createDistanceFields = [&](const FIntRect& sourceRect, const FIntRect& sdfRect, bool skipEmptyChannels, TArray<bool>& outRectSuccess)
+		{
+			bool anySuccess = false;
+			VisitPixelFormat(sourceBufferDef, [&](auto format)
+			{
+				using TFormat = decltype(format);
+				const auto* typedSource = reinterpret_cast<const typename TFormat::TChannel*>(sourceBuffer);
+				anySuccess = Internal::CreateDistanceFields<TFormat>(typedSource, sourceBufferDef, sourceRect, outSDFBuffer, sdfBufferDef, sdfRect, searchMappings, engine, skipEmptyChannels, searchTileSize, edgeTolerance, outRectSuccess);
+			});
+
+			return anySuccess;
+		};
+
+		if(!VisitPixelFormat(sourceBufferDef, [](auto) {}))
+		{
+			UE_LOG(RTMSDF, Error, TEXT("Unsupported source format (ETextureSourceFormat = %d) with %d channels"), static_cast<int>(sourceBufferDef.Format), sourceBufferDef.NumChannels);
+			outSuccess.Init(false, mappings.Num());
+			return false;
+		}
+
+		const FIntRect sdfBounds(0, 0, sdfBufferDef.Width, sdfBufferDef.Height);
+		if(tileSize <= 0 || (tileSize >= sdfBufferDef.Width && tileSize >= sdfBufferDef.Height))
+		{
+			// Only wrapped axes get a halo, the others keep the whole source as before
+			FIntRect sourceRect = Internal::FindSourceRect(sdfBounds, sdfBufferDef, sourceBufferDef, searchMappings, halo, wrapX, wrapY);
+			if(!wrapX)
+			{
+				sourceRect.Min.X = 0;
+				sourceRect.Max.X = sourceBufferDef.Width;
+			}
+			if(!wrapY)
+			{
+				sourceRect.Min.Y = 0;
+				sourceRect.Max.Y = sourceBufferDef.Height;
+			}
 
-				const uint8 mipVal8 = Internal::ComputePixelValue(sourcePos, sourceBuffer, sourceBufferDef, mapping.SourceChannel);
-				const bool outside = mipVal8 < 127;
-				const float dist = FMath::Sqrt(search.ClosestDistanceSq);
-				const float signedDist = (outside ^ mapping.bInvertDistance) ? dist : -dist;
-				const float distN = signedDist / searchRange + 0.5f;
-				const uint8 sdfMip = distN >= halfFieldDistance ? 255 : FMath::Clamp(FMath::FloorToInt(distN * 255.0f), 0, 255);
+			return createDistanceFields(sourceRect, sdfBounds, true, outSuccess);
+		}
+
+		const uint64 cyclesStart = FPlatformTime::Cycles();
+
+		// Each tile copies the source under its output pixels, plus the halo, and builds its edge search from that copy
+		// Tiles are claimed in order by a fixed number of slots, so only that many copies and searches exist at once, however large the SDF
+		const int numTilesX = FMath::DivideAndRoundUp(sdfBufferDef.Width, tileSize);
+		const int numTilesY = FMath::DivideAndRoundUp(sdfBufferDef.Height, tileSize);
+		const int numTiles = numTilesX * numTilesY;
+		TArray<TArray<bool>> tileSuccess;
+		tileSuccess.SetNum(numTiles);
 
-				const int sdfPixelIdx = i * sdfBufferDef.NumChannels + mapping.TargetChannel;
-				outSDFBuffer[sdfPixelIdx] = sdfMip;
+		std::atomic_int nextTile = 0;
+		ParallelFor(FMath::Min(numTiles, GENERATION_TILE_SLOTS), [&](const int)
+		{
+			for(int tileIdx = nextTile++; tileIdx < numTiles; tileIdx = nextTile++)
+			{
+				const FIntPoint tileMin((tileIdx % numTilesX) * tileSize, (tileIdx / numTilesX) * tileSize);
+				const FIntRect sdfRect(tileMin, FIntPoint(FMath::Min(tileMin.X + tileSize, sdfBufferDef.Width), FMath::Min(tileMin.Y + tileSize, sdfBufferDef.Height)));
+				const FIntRect sourceRect = Internal::FindSourceRect(sdfRect, sdfBufferDef, sourceBufferDef, searchMappings, halo, wrapX, wrapY);
+				createDistanceFields(sourceRect, sdfRect, false, tileSuccess[tileIdx]);
 			}
 		});
 
+		// Every tile has been written, so channels without edges in any tile are returned to their untouched state
+		outSuccess.Init(false, mappings.Num());
+		bool anySuccess = false;
+		for(int i = 0; i < mappings.Num(); ++i)
+		{
+			for(const TArray<bool>& success : tileSuccess)
+				outSuccess[i] |= success[i];
+
+			anySuccess |= outSuccess[i];
+			if(!outSuccess[i])
+				SetChannelUniformValue(outSDFBuffer, sdfBufferDef, mappings[i].TargetChannel, 0);
+		}
+
+		const uint64 cyclesEnd = FPlatformTime::Cycles();
+		UE_LOG(RTMSDF, Verbose, TEXT("Generated %d tiles of %dx%d pixels with a %d pixel source halo (%.2fms)"), tileSuccess.Num(), tileSize, tileSize, halo, FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+		return anySuccess;
+	}
+
+	bool FindEdges(const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, int channelOffset, TArray<FVector2f>& outEdgePoints)
+	{
+		TArray<TArray<FVector2f>> edgePoints;
+		const bool supported = VisitPixelFormat(sourceBufferDef, [&](auto format)
+		{
+			using TFormat = decltype(format);
+			Internal::FindEdges<TFormat>({reinterpret_cast<const typename TFormat::TChannel*>(sourceBuffer)}, sourceBufferDef, channelOffset, false, edgePoints);
+		});
+
+		outEdgePoints = supported ? MoveTemp(edgePoints[0]) : TArray<FVector2f>();
+		return outEdgePoints.Num() > 0;
+	}
+
+	bool TraceContours(const TArray<FVector2f>& edgePoints, float tolerance, TArray<TArray<FVector2f>>& outPolylines)
+	{
+		Internal::TraceContours(edgePoints, tolerance, outPolylines);
+		return outPolylines.Num() > 0;
+	}
+
+	bool PopulateEdgeTree(const TArray<FVector2f>& edgePoints, FQuadTree& tree)
+	{
+		const uint64 cyclesStart = FPlatformTime::Cycles();
+
+		tree.AddItems(edgePoints);
+		const uint64 cyclesPopulated = FPlatformTime::Cycles();
+
+		tree.Freeze();
+
+		const uint64 cyclesEnd = FPlatformTime::Cycles();
+		const int numEdges = tree.Edges.Num();
+		UE_LOG(RTMSDF, Verbose, TEXT("Num Edges/Cells %d/%d (%.2fms)"), numEdges, tree.Cells.Num(), FPlatformTime::ToMilliseconds(cyclesPopulated-cyclesStart));
+		UE_LOG(RTMSDF, Verbose, TEXT("Froze QuadTree with %d leaf edges (%.2fms)"), tree.LeafP1X.Num(), FPlatformTime::ToMilliseconds(cyclesEnd-cyclesPopulated));
+		UE_LOG(RTMSDF, VeryVerbose, TEXT("%s"), *tree.ToString());
+
+		return numEdges > 0;
+	}
+
+	bool PopulateDistanceTransform(const TArray<FVector2f>& edgePoints, FDistanceTransform& distanceTransform)
+	{
+		const uint64 cyclesStart = FPlatformTime::Cycles();
+
+		for(int i = 0; i + 1 < edgePoints.Num(); i += 2)
+			distanceTransform.AddItem(edgePoints[i], edgePoints[i + 1]);
+		distanceTransform.Build();
+
 		const uint64 cyclesEnd = FPlatformTime::Cycles();
-		UE_LOG(RTMSDF, Verbose, TEXT("Populated Distance Field from QuadTree %d pixels (%.2fms)"), sdfBufferDef.Width * sdfBufferDef.Height, FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+		const int numEdges = distanceTransform.EdgePoints.Num() / 2;
+		UE_LOG(RTMSDF, Verbose, TEXT("Num Edges/Cells %d/%d (%.2fms)"), numEdges, distanceTransform.Width * distanceTransform.Height, FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+
+		return numEdges > 0;
+	}
+
+	void FindDistances(const FQuadTree& tree, const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping, int searchTileSize)
+	{
+		VisitPixelFormat(sourceBufferDef, [&](auto format)
+		{
+			using TFormat = decltype(format);
+			Internal::FindDistances<FQuadTree, TFormat>(tree, reinterpret_cast<const typename TFormat::TChannel*>(sourceBuffer), sourceBufferDef, outSDFBuffer, sdfBufferDef, mapping, searchTileSize > 0 ? searchTileSize : TREESEARCH_DEFAULT_TILE_SIZE);
+		});
+	}
+
+	void FindDistances(const FDistanceTransform& distanceTransform, const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping, int searchTileSize)
+	{
+		VisitPixelFormat(sourceBufferDef, [&](auto format)
+		{
+			using TFormat = decltype(format);
+			Internal::FindDistances<FDistanceTransform, TFormat>(distanceTransform, reinterpret_cast<const typename TFormat::TChannel*>(sourceBuffer), sourceBufferDef, outSDFBuffer, sdfBufferDef, mapping, searchTileSize > 0 ? searchTileSize : TREESEARCH_DEFAULT_TILE_SIZE);
+		});
 	}
 }
@@ -33,11 +33,15 @@ ERTMSDF_BitmapChannelBehavior FRTMSDF_BitmapGenerationSettings::GetChannelBehavi
 {
 	switch(Format)
 	{
-		case ERTMSDF_SDFFormat::SingleChannel: return channel == SDFChannel ? ERTMSDF_BitmapChannelBehavior::SDF : ERTMSDF_BitmapChannelBehavior::Discard;
+		case ERTMSDF_SDFFormat::SingleChannel:
+		case ERTMSDF_SDFFormat::SingleChannel16:
+		case ERTMSDF_SDFFormat::SingleChannelHalf:
+		case ERTMSDF_SDFFormat::Multichannel:
+		case ERTMSDF_SDFFormat::MultichannelPlusAlpha: return channel == SDFChannel ? ERTMSDF_BitmapChannelBehavior::SDF : ERTMSDF_BitmapChannelBehavior::Discard;
 		case ERTMSDF_SDFFormat::SeparateChannels: return GetSeparatedChannelBehavior(channel);
 
 		default:
-			static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 5);
+			static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 7);
 			const int enumIntValue = static_cast<int>(Format);
 			const auto* uenumPtr = StaticEnum<ERTMSDF_SDFFormat>();
 			const FString enumName = uenumPtr->GetNameStringByValue(enumIntValue);
@@ -73,11 +77,15 @@ ERTMSDF_Channels FRTMSDF_BitmapGenerationSettings::GetChannelMapping(ERTMSDF_Cha
 {
 	switch(Format)
 	{
-		case ERTMSDF_SDFFormat::SingleChannel: return SDFChannel;
+		case ERTMSDF_SDFFormat::SingleChannel:
+		case ERTMSDF_SDFFormat::SingleChannel16:
+		case ERTMSDF_SDFFormat::SingleChannelHalf:
+		case ERTMSDF_SDFFormat::Multichannel:
+		case ERTMSDF_SDFFormat::MultichannelPlusAlpha: return SDFChannel;
 		case ERTMSDF_SDFFormat::SeparateChannels: return sdfChannel;
 
 		default:
-			static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 5);
+			static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 7);
 			const int enumIntValue = static_cast<int>(Format);
 			const auto* uenumPtr = StaticEnum<ERTMSDF_SDFFormat>();
 			const FString enumName = uenumPtr->GetNameStringByValue(enumIntValue);
@@ -0,0 +1,271 @@
+﻿// Copyright (c) Richard Meredith AB. All Rights Reserved
+
+#include "Generation/Bitmap/RTMSDF_DistanceTransform.h"
+#include "Generation/Bitmap/RTMSDF_QuadTree.h"
+#include "Generation/Common/RTMSDF_Utilities.h"
+#include "Async/ParallelFor.h"
+
+namespace RTM::SDF
+{
+	FDistanceTransform::FDistanceTransform(int32 width, int32 height, int32 reserveEdges)
+		: Width(width)
+		, Height(height)
+	{
+		if(reserveEdges > 0)
+			EdgePoints.Reserve(reserveEdges * 2);
+	}
+
+	void FDistanceTransform::AddItem(const FVector2f& edgePointA, const FVector2f& edgePointB)
+	{
+		EdgePoints.Add(edgePointA);
+		EdgePoints.Add(edgePointB);
+	}
+
+	void FDistanceTransform::Build()
+	{
+		BuildCellEdges();
+
+		const int32 numCells = Width * Height;
+		NearestEdgeCell.SetNumUninitialized(numCells);
+		if(NumEdges() == 0)
+		{
+			for(int32 i = 0; i < numCells; ++i)
+				NearestEdgeCell[i] = INDEX_NONE;
+			return;
+		}
+
+		// First pass: nearest edge cell within each column
+		TArray<int32> nearestRows;
+		nearestRows.SetNumUninitialized(numCells);
+		ParallelFor(Width, [&](const int32 x)
+		{
+			BuildColumn(x, nearestRows);
+		});
+
+		// Second pass: lower envelope of the column distances along each row
+		ParallelFor(Height, [&](const int32 y)
+		{
+			BuildRow(y, nearestRows);
+		});
+	}
+
+	bool FDistanceTransform::FindDistance(FSearchContext& context) const
+	{
+		if(NumEdges() == 0)
+			return false;
+
+		// NOTE: any seeded NearestEdge is ignored, as the nearest edge cell is already known
+		// Queries outside the source, such as the margin added by scaling to fit, look up the border cell nearest them. The bounds below account for how far away it is
+		const FIntPoint queryCell = GetCell(context.P);
+		const int32 nearestCell = NearestEdgeCell[queryCell.Y * Width + queryCell.X];
+		check(nearestCell != INDEX_NONE);
+
+		const FIntPoint nearestCellPos(nearestCell % Width, nearestCell / Width);
+		const int64 nearestCellDistanceSq = FMath::Square<int64>(nearestCellPos.X - queryCell.X) + FMath::Square<int64>(nearestCellPos.Y - queryCell.Y);
+		const float queryOffset = FVector2f::Distance(context.P, FVector2f(queryCell) + 0.5f);
+
+		// No cell centre is nearer to the query cell's than the nearest edge cell's, and no edge reaches further than MaxEdgeReach from its cell centre, so no edge is nearer than this
+		const float minEdgeDistance = FMath::Sqrt(static_cast<float>(nearestCellDistanceSq)) - queryOffset - MaxEdgeReach;
+		if(minEdgeDistance > 0.0f && FMath::Square(minEdgeDistance) >= context.ClosestDistanceSq)
+			return false;
+
+		bool anyFound = SearchCell(nearestCell, context);
+
+		// The nearest edge cell is only nearest by cell centres, so the nearest edge may be in any edge cell whose centre is within the closest distance plus MaxEdgeReach
+		// Those cells form a ring around the query cell, as everything inside the nearest edge cell's distance is known to be empty
+		const float firstRowY = context.P.Y - FMath::Sqrt(context.ClosestDistanceSq) - MaxEdgeReach - 0.5f;
+		const float lastRowY = context.P.Y + FMath::Sqrt(context.ClosestDistanceSq) + MaxEdgeReach - 0.5f;
+		for(int32 y = FMath::Max(FMath::CeilToInt(firstRowY), 0); y <= FMath::Min(FMath::FloorToInt(lastRowY), Height - 1); ++y)
+		{
+			// The search radius shrinks as nearer edges are found
+			const float searchRadius = FMath::Sqrt(context.ClosestDistanceSq) + MaxEdgeReach;
+			const float rowOffsetY = y + 0.5f - context.P.Y;
+			const float rowHalfWidthSq = FMath::Square(searchRadius) - FMath::Square(rowOffsetY);
+			if(rowHalfWidthSq < 0.0f)
+				continue;
+
+			const float rowHalfWidth = FMath::Sqrt(rowHalfWidthSq);
+			const int32 minX = FMath::Max(FMath::CeilToInt(context.P.X - rowHalfWidth - 0.5f), 0);
+			const int32 maxX = FMath::Min(FMath::FloorToInt(context.P.X + rowHalfWidth - 0.5f), Width - 1);
+
+			// Cells of this row strictly nearer the query cell than the nearest edge cell are empty
+			const int64 emptyHalfWidthSq = nearestCellDistanceSq - FMath::Square<int64>(y - queryCell.Y);
+			const int32 emptyHalfWidth = emptyHalfWidthSq > 0 ? FMath::CeilToInt(FMath::Sqrt(static_cast<double>(emptyHalfWidthSq))) - 1 : -1;
+			for(int32 x = minX; x <= maxX; ++x)
+			{
+				if(FMath::Abs(x - queryCell.X) <= emptyHalfWidth)
+				{
+					x = queryCell.X + emptyHalfWidth;
+					continue;
+				}
+
+				const int32 cellIdx = y * Width + x;
+				if(cellIdx != nearestCell)
+					anyFound |= SearchCell(cellIdx, context);
+			}
+		}
+
+		return anyFound;
+	}
+
+	bool FDistanceTransform::FindDistance(TArrayView<FSearchContext> contexts) const
+	{
+		// Each query searches a different ring of cells, so there is no shared work to gain from searching a packet together
+		bool anyFound = false;
+		for(FSearchContext& context : contexts)
+			anyFound |= FindDistance(context);
+
+		return anyFound;
+	}
+
+	void FDistanceTransform::BuildCellEdges()
+	{
+		// Counting sort of the edges into their cells, so each cell's edges are contiguous
+		const int32 numCells = Width * Height;
+		const int32 numEdges = NumEdges();
+
+		TArray<int32> edgeCells;
+		edgeCells.SetNumUninitialized(numEdges);
+		CellEdgeStart.SetNumZeroed(numCells + 1);
+		float maxEdgeReachSq = 0.0f;
+		for(int32 e = 0; e < numEdges; ++e)
+		{
+			const FIntPoint cell = GetCell((EdgePoints[e * 2] + EdgePoints[e * 2 + 1]) * 0.5f);
+			edgeCells[e] = cell.Y * Width + cell.X;
+			++CellEdgeStart[edgeCells[e] + 1];
+
+			// Segments are furthest from the cell centre at one of their ends
+			const FVector2f cellCentre = FVector2f(cell) + 0.5f;
+			maxEdgeReachSq = FMath::Max3(maxEdgeReachSq, FVector2f::DistSquared(EdgePoints[e * 2], cellCentre), FVector2f::DistSquared(EdgePoints[e * 2 + 1], cellCentre));
+		}
+
+		// Slightly widened, so rounding can never exclude the cell of the nearest edge
+		MaxEdgeReach = FMath::Sqrt(maxEdgeReachSq) + UE_KINDA_SMALL_NUMBER;
+
+		for(int32 i = 0; i < numCells; ++i)
+			CellEdgeStart[i + 1] += CellEdgeStart[i];
+
+		TArray<int32> cellCursors(CellEdgeStart.GetData(), numCells);
+		TArray<FVector2f> sortedPoints;
+		sortedPoints.SetNumUninitialized(EdgePoints.Num());
+		for(int32 e = 0; e < numEdges; ++e)
+		{
+			const int32 sortedIdx = cellCursors[edgeCells[e]]++;
+			sortedPoints[sortedIdx * 2] = EdgePoints[e * 2];
+			sortedPoints[sortedIdx * 2 + 1] = EdgePoints[e * 2 + 1];
+		}
+
+		EdgePoints = MoveTemp(sortedPoints);
+	}
+
+	void FDistanceTransform::BuildColumn(int32 x, TArray<int32>& outNearestRows) const
+	{
+		auto hasEdges = [this, x](int32 y) { const int32 i = y * Width + x; return CellEdgeStart[i + 1] > CellEdgeStart[i]; };
+
+		int32 lastRow = INDEX_NONE;
+		for(int32 y = 0; y < Height; ++y)
+		{
+			if(hasEdges(y))
+				lastRow = y;
+			outNearestRows[y * Width + x] = lastRow;
+		}
+
+		lastRow = INDEX_NONE;
+		for(int32 y = Height - 1; y >= 0; --y)
+		{
+			if(hasEdges(y))
+				lastRow = y;
+
+			const int32 i = y * Width + x;
+			const int32 aboveRow = outNearestRows[i];
+			if(lastRow != INDEX_NONE && (aboveRow == INDEX_NONE || lastRow - y < y - aboveRow))
+				outNearestRows[i] = lastRow;
+		}
+	}
+
+	void FDistanceTransform::BuildRow(int32 y, const TArray<int32>& nearestRows)
+	{
+		// Felzenszwalb & Huttenlocher lower envelope of parabolas, one rooted at each column that has an edge cell anywhere in it
+		// Doubles are required as squared distances on large sources exceed the range floats can represent exactly
+		const int32* rowNearestRows = nearestRows.GetData() + y * Width;
+		TArray<int32> parabolaColumns;
+		TArray<double> boundaries;
+		parabolaColumns.SetNumUninitialized(Width);
+		boundaries.SetNumUninitialized(Width + 1);
+
+		auto parabolaHeight = [rowNearestRows, y](int32 q)
+		{
+			const double dy = rowNearestRows[q] - y;
+			return dy * dy + static_cast<double>(q) * q;
+		};
+
+		auto intersect = [&parabolaHeight](int32 q, int32 v)
+		{
+			return (parabolaHeight(q) - parabolaHeight(v)) / (2.0 * (q - v));
+		};
+
+		int32 k = -1;
+		for(int32 q = 0; q < Width; ++q)
+		{
+			if(rowNearestRows[q] == INDEX_NONE)
+				continue;
+
+			if(k < 0)
+			{
+				k = 0;
+				parabolaColumns[0] = q;
+				boundaries[0] = -DBL_MAX;
+				boundaries[1] = DBL_MAX;
+				continue;
+			}
+
+			double s = intersect(q, parabolaColumns[k]);
+			while(k > 0 && s <= boundaries[k])
+			{
+				--k;
+				s = intersect(q, parabolaColumns[k]);
+			}
+
+			++k;
+			parabolaColumns[k] = q;
+			boundaries[k] = s;
+			boundaries[k + 1] = DBL_MAX;
+		}
+
+		check(k >= 0);
+		k = 0;
+		for(int32 x = 0; x < Width; ++x)
+		{
+			while(boundaries[k + 1] < x)
+				++k;
+
+			const int32 column = parabolaColumns[k];
+			NearestEdgeCell[y * Width + x] = nearestRows[y * Width + column] * Width + column;
+		}
+	}
+
+	bool FDistanceTransform::SearchCell(int32 cellIdx, FSearchContext& context) const
+	{
+		++context.NumCellsVisited;
+		for(int32 e = CellEdgeStart[cellIdx]; e < CellEdgeStart[cellIdx + 1]; ++e)
+		{
+			const FVector2f& closestPointOnEdge = Utils::ClosestPointOnSegment2D(context.P, EdgePoints[e * 2], EdgePoints[e * 2 + 1]);
+			const float foundDistanceSq = FVector2f::DistSquared(context.P, closestPointOnEdge);
+
+			++context.NumEdgesTested;
+			if(foundDistanceSq < context.ClosestDistanceSq)
+			{
+				context.ClosestDistanceSq = foundDistanceSq;
+				context.NearestEdge = e;
+			}
+		}
+
+		return CellEdgeStart[cellIdx + 1] > CellEdgeStart[cellIdx];
+	}
+
+	FIntPoint FDistanceTransform::GetCell(const FVector2f& pos) const
+	{
+		// Positions outside the source are clamped to the nearest border cell
+		return FIntPoint(FMath::Clamp(FMath::FloorToInt(pos.X), 0, Width - 1), FMath::Clamp(FMath::FloorToInt(pos.Y), 0, Height - 1));
+	}
+}
@@ -2,13 +2,18 @@
 
 #include "Generation/Bitmap/RTMSDF_QuadTree.h"
 #include "Generation/Common/RTMSDF_Utilities.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+
+#define QUADTREE_PARALLEL_BUILD_DEPTH 3 // Depth the root is split to before building the resulting tiles (4^depth of them) on separate threads
+#define QUADTREE_PARALLEL_BUILD_MIN_EDGES 4096 // Fewer edges than this are quicker to add serially than to split into tiles
 
 namespace RTM::SDF
 {
 	static constexpr bool TestIntersection(const FCell& cell, const FEdgeData& edge)
 	{
-		const int16 cMaxX = cell.MinX + cell.Size;
-		const int16 cMaxY = cell.MinY + cell.Size;
+		const int32 cMaxX = cell.MinX + cell.Size;
+		const int32 cMaxY = cell.MinY + cell.Size;
 
 		return !(edge.MinX >= cMaxX
 			|| edge.MinY >= cMaxY
@@ -18,8 +23,8 @@ namespace RTM::SDF
 
 	static constexpr bool TestIntersection(const FCell& cell, const FSearchContext& context)
 	{
-		const int16 cMaxX = cell.MinX + cell.Size;
-		const int16 cMaxY = cell.MinY + cell.Size;
+		const int32 cMaxX = cell.MinX + cell.Size;
+		const int32 cMaxY = cell.MinY + cell.Size;
 
 		return !(context.MinX >= cMaxX
 			|| context.MinY >= cMaxY
@@ -27,6 +32,14 @@ namespace RTM::SDF
 			|| context.MaxY <= cell.MinY);
 	}
 
+	static constexpr bool TestIntersection(const FFrozenCell& cell, const FSearchContext& context)
+	{
+		return !(context.MinX >= cell.MaxX
+			|| context.MinY >= cell.MaxY
+			|| context.MaxX <= cell.MinX
+			|| context.MaxY <= cell.MinY);
+	}
+
 	static constexpr bool TestIntersection(const FSearchContext& context, const FEdgeData& edge)
 	{
 		return !(context.MinX >= edge.MaxX
@@ -35,10 +48,23 @@ namespace RTM::SDF
 			|| context.MaxY <= edge.MinY);
 	}
 
+	static void Subdivide(TArray<FCell>& cells, uint32 cellID)
+	{
+		const int32 childSize = cells[cellID].Size >> 1;	// NOTE: never called on cells of the minimum size (1), which overflow instead. See AddItem
+		for(int c = 0; c < 4; ++c)
+		{
+			const int32 childX = cells[cellID].MinX + ((c & 1) ? childSize : 0);
+			const int32 childY = cells[cellID].MinY + ((c > 1) ? childSize : 0);
+			cells[cellID].Children[c] = cells.Add({childX, childY, childSize});
+		}
+		cells[cellID].bChildCells = true;
+		cells[cellID].NumChildren = 4;
+	}
+
 	static constexpr uint32 GetOverlapArea(const FCell& cell, const FSearchContext& context)
 	{
-		const int16 cMaxX = cell.MinX + cell.Size;
-		const int16 cMaxY = cell.MinY + cell.Size;
+		const int32 cMaxX = cell.MinX + cell.Size;
+		const int32 cMaxY = cell.MinY + cell.Size;
 
 		const int32 xMin = FMath::Max(cell.MinX, context.MinX);
 		const int32 yMin = FMath::Max(cell.MinY, context.MinY);
@@ -51,7 +77,7 @@ namespace RTM::SDF
 		return overlapArea;
 	}
 
-	FQuadTree::FQuadTree(int16 sizeX, int16 sizeY, size_t reserveEdges, size_t reserveCells)
+	FQuadTree::FQuadTree(int32 sizeX, int32 sizeY, size_t reserveEdges, size_t reserveCells)
 	{
 		if(reserveEdges > 0)
 			Edges.Reserve(reserveEdges);
@@ -59,9 +85,9 @@ namespace RTM::SDF
 		if(reserveCells > 0)
 			Cells.Reserve(reserveCells);
 
-		const int16 size = Utils::RoundUpToPow2(FMath::Max(sizeX, sizeY));
-		const int16 offsetX = (sizeX - size) / 2;
-		const int16 offsetY = (sizeY - size) / 2;
+		const int32 size = Utils::RoundUpToPow2(FMath::Max(sizeX, sizeY));
+		const int32 offsetX = (sizeX - size) / 2;
+		const int32 offsetY = (sizeY - size) / 2;
 		Cells.Add({offsetX, offsetY, size});
 	}
 
@@ -69,26 +95,123 @@ namespace RTM::SDF
 	{
 		check(Cells.Num() > 0);
 
-		const uint16 edgeIDX = Edges.Add({edgePointA, edgePointB});
+		FrozenCells.Reset();
+
+		const uint32 edgeIDX = Edges.Add({edgePointA, edgePointB});
 		const FEdgeData& newEdge = Edges[edgeIDX];
 
-		constexpr int16 rootCellIDX = 0;
+		constexpr int32 rootCellIDX = 0;
 		const FCell& rootCell = Cells[rootCellIDX];
 
 		if(TestIntersection(rootCell, newEdge))
-			AddItem(rootCellIDX, newEdge, edgeIDX);
+			AddItem(Cells, Edges, rootCellIDX, newEdge, edgeIDX);
+	}
+
+	void FQuadTree::AddItems(const TArray<FVector2f>& edgePoints)
+	{
+		const int32 numNewEdges = edgePoints.Num() / 2;
+		const bool emptyTree = Edges.Num() == 0 && Cells.Num() == 1;
+		if(emptyTree && numNewEdges >= QUADTREE_PARALLEL_BUILD_MIN_EDGES && (Cells[0].Size >> QUADTREE_PARALLEL_BUILD_DEPTH) > 0)
+		{
+			AddItemsParallel(edgePoints);
+			return;
+		}
+
+		for(int32 i = 0; i < numNewEdges; ++i)
+			AddItem(edgePoints[i * 2], edgePoints[i * 2 + 1]);
+	}
+
+	void FQuadTree::Freeze()
+	{
+		check(Cells.Num() > 0);
+
+		FrozenCells.Reset(Cells.Num());
+		for(TArray<float>* leafArray : {&LeafP1X, &LeafP1Y, &LeafP2X, &LeafP2Y})
+			leafArray->Reset(Edges.Num());
+
+		FrozenCells.AddDefaulted();
+		FreezeCell(Cells[0], 0);
 	}
 
 	bool FQuadTree::FindDistance(FSearchContext& context) const
 	{
-		if(Edges.Num() == 0)
+		return FindDistance(MakeArrayView(&context, 1));
+	}
+
+	bool FQuadTree::FindDistance(TArrayView<FSearchContext> contexts) const
+	{
+		check(contexts.Num() <= MaxPacketSize);
+
+		if(Edges.Num() == 0 || contexts.Num() == 0)
 			return false;
 
-		check(Cells.Num() > 0);
-		const FCell& rootCell = Cells[0];
+		checkf(IsFrozen(), TEXT("FQuadTree must be frozen before searching"));
+
+		auto testAnyIntersection = [&contexts](const FFrozenCell& cell)
+		{
+			for(const FSearchContext& context : contexts)
+			{
+				if(TestIntersection(cell, context))
+					return true;
+			}
+			return false;
+		};
+
+		// Seeded edges are tested before traversal, so that their distance can cull cells from the start
+		for(FSearchContext& context : contexts)
+		{
+			if(context.NearestEdge != INDEX_NONE)
+				FindEdgeDistance(context.NearestEdge, context);
+		}
+
+		// Child ordering follows the first point of the packet, as the others are expected to be close enough to it to want the same order
+		FSearchContext& leadContext = contexts[0];
+		const FVector2f& leadP = leadContext.P;
+
+		bool anyFound = false;
+		TArray<uint32, TInlineAllocator<64>> cellStack;
+		cellStack.Push(0);
+
+		while(cellStack.Num() > 0)
+		{
+			const FFrozenCell& cell = FrozenCells[cellStack.Pop()];
+
+			// NOTE: tested when popped rather than pushed, so that siblings are culled against any closer edges found in the previous sibling's subtree
+			if(!testAnyIntersection(cell))
+				continue;
+
+			++leadContext.NumCellsVisited;
+
+			if(cell.bChildCells)
+			{
+				// Quick and dirty check to see which quadrant to search in first, with the hope of finding an edge in there that makes the other quadrants skippable in broadphase
+				// Seems to shave around 15% total search time (depending on asset). Maybe worth investigating improved patterns, but expect diminishing returns
+				const bool toRight = leadP.X > cell.MaxX;
+				const bool below = leadP.Y > cell.MaxY;
+				const int firstCell = (toRight ? 1 : 0) + (below ? 2 : 0);
+
+				// Pushed in reverse, so they are popped in search order
+				for(int i = 3; i >= 0; --i)
+				{
+					const uint32 childCellIdx = cell.FirstChild + (firstCell + i) % 4;
+					if(FrozenCells[childCellIdx].NumChildren > 0)
+						cellStack.Push(childCellIdx);
+				}
+			}
+			else if(cell.NumChildren > 0)	// Children are leaf nodes, so just to a distance check against them
+			{
+				anyFound = true;
 
-		return TestIntersection(rootCell, context) &&
-			FindDistance(rootCell, context);
+				// Points whose own bounds miss this leaf would skip it when searched alone, and cannot find a closer edge in it anyway
+				for(FSearchContext& context : contexts)
+				{
+					if(TestIntersection(cell, context))
+						FindLeafDistance(cell, context);
+				}
+			}
+		}
+
+		return anyFound;
 	}
 
 	FString FQuadTree::ToString() const
@@ -96,117 +219,268 @@ namespace RTM::SDF
 		return ToString(Cells[0], TEXT(""));
 	}
 
-	void FQuadTree::AddItem(const uint16 cellID, const FEdgeData& edgeData, uint16 edgeIDX)
+	void FQuadTree::AddItemsParallel(const TArray<FVector2f>& edgePoints)
+	{
+		FrozenCells.Reset();
+
+		const int32 numNewEdges = edgePoints.Num() / 2;
+		Edges.Reserve(numNewEdges);
+		for(int32 i = 0; i < numNewEdges; ++i)
+			Edges.Add({edgePoints[i * 2], edgePoints[i * 2 + 1]});
+
+		// Split the root into a grid of tiles. This may split cells that a serial build would have left as leaves, which costs a few empty cells but doesn't affect searches
+		constexpr int32 tileGridSize = 1 << QUADTREE_PARALLEL_BUILD_DEPTH;
+		const FCell rootCell = Cells[0];
+		const int32 tileSize = rootCell.Size >> QUADTREE_PARALLEL_BUILD_DEPTH;
+
+		TArray<uint32> levelCells = {0};
+		for(int32 depth = 0; depth < QUADTREE_PARALLEL_BUILD_DEPTH; ++depth)
+		{
+			TArray<uint32> nextLevelCells;
+			for(const uint32 cellIdx : levelCells)
+			{
+				Subdivide(Cells, cellIdx);
+				nextLevelCells.Append(Cells[cellIdx].Children, 4);
+			}
+			levelCells = MoveTemp(nextLevelCells);
+		}
+
+		TArray<uint32> tileCells;
+		tileCells.SetNumUninitialized(tileGridSize * tileGridSize);
+		for(const uint32 cellIdx : levelCells)
+		{
+			const int32 tileX = (Cells[cellIdx].MinX - rootCell.MinX) / tileSize;
+			const int32 tileY = (Cells[cellIdx].MinY - rootCell.MinY) / tileSize;
+			tileCells[tileY * tileGridSize + tileX] = cellIdx;
+		}
+
+		// Bin the edges into every tile they overlap, keeping them in the order they were added
+		TArray<TArray<uint32>> tileEdges;
+		tileEdges.SetNum(tileCells.Num());
+		auto toTile = [tileSize](int32 minCoord, int32 pos) { return FMath::Clamp((pos - minCoord) / tileSize, 0, tileGridSize - 1); };
+		for(int32 edgeIdx = 0; edgeIdx < Edges.Num(); ++edgeIdx)
+		{
+			const FEdgeData& edge = Edges[edgeIdx];
+			for(int32 tileY = toTile(rootCell.MinY, edge.MinY); tileY <= toTile(rootCell.MinY, edge.MaxY); ++tileY)
+			{
+				for(int32 tileX = toTile(rootCell.MinX, edge.MinX); tileX <= toTile(rootCell.MinX, edge.MaxX); ++tileX)
+				{
+					const int32 tileIdx = tileY * tileGridSize + tileX;
+					if(TestIntersection(Cells[tileCells[tileIdx]], edge))
+						tileEdges[tileIdx].Add(edgeIdx);
+				}
+			}
+		}
+
+		// Build each tile as a separate tree, rooted at a copy of the tile's cell
+		TArray<TArray<FCell>> tileTrees;
+		tileTrees.SetNum(tileCells.Num());
+		ParallelFor(tileCells.Num(), [&](const int32 tileIdx)
+		{
+			TArray<FCell>& tileTree = tileTrees[tileIdx];
+			tileTree.Reserve(tileEdges[tileIdx].Num() / 2 + 1);
+			tileTree.Add(Cells[tileCells[tileIdx]]);
+			for(const uint32 edgeIdx : tileEdges[tileIdx])
+				AddItem(tileTree, Edges, 0, Edges[edgeIdx], edgeIdx);
+		});
+
+		// Stitch the tiles' trees back under their cells, offsetting child cell indices into the main cell array
+		int32 numCells = Cells.Num();
+		for(const TArray<FCell>& tileTree : tileTrees)
+			numCells += tileTree.Num() - 1;
+		Cells.Reserve(numCells);
+
+		for(int32 tileIdx = 0; tileIdx < tileTrees.Num(); ++tileIdx)
+		{
+			const uint32 cellOffset = Cells.Num() - 1;
+			auto remapCell = [cellOffset](FCell cell)
+			{
+				if(cell.bChildCells)
+				{
+					for(uint32& childIdx : cell.Children)
+						childIdx += cellOffset;
+				}
+				if(cell.Overflow != FCell::INVALID)
+					cell.Overflow += cellOffset;
+				return cell;
+			};
+
+			const TArray<FCell>& tileTree = tileTrees[tileIdx];
+			Cells[tileCells[tileIdx]] = remapCell(tileTree[0]);
+			for(int32 i = 1; i < tileTree.Num(); ++i)
+				Cells.Add(remapCell(tileTree[i]));
+		}
+	}
+
+	void FQuadTree::AddItem(TArray<FCell>& cells, const TArray<FEdgeData>& edges, const uint32 cellID, const FEdgeData& edgeData, uint32 edgeIDX)
 	{
 		// NOTE: it is required that calls into this function have already verified that the edge intersects this cell
 
-		const auto cell = Cells[cellID];
+		const auto cell = cells[cellID];
 		if(cell.bChildCells)
 		{
 			// check which of the 4 subcells overlap the edge and add it.
 			// Note it is possible for multiple cells to overlap the edge
 			for(int i = 0; i < 4; ++i)
 			{
-				const uint16 childCellIdx = cell.Children[i];
+				const uint32 childCellIdx = cell.Children[i];
 				check(childCellIdx != FCell::INVALID);
-				FCell& childCell = Cells[childCellIdx];
+				FCell& childCell = cells[childCellIdx];
 
 				// NOTE: hit rate around 20-30% here - might be possible to improve with branch prediction
 				// However, UE UNLIKELY doesn't operate on windows and cpp [[unlikely]] has no measurable effect (poss not implemented either?)
 				if(TestIntersection(childCell, edgeData))
-					AddItem(childCellIdx, edgeData, edgeIDX);
+					AddItem(cells, edges, childCellIdx, edgeData, edgeIDX);
 			}
 		}
-		else if(Cells[cellID].NumChildren == 4)
+		else if(cells[cellID].NumChildren == 4 && cell.Size <= 1)
 		{
-			// Need to reposition all of the 5 children (4 existing and 1 new);
-			const uint16 childEdgeIDXs[5] = {Cells[cellID].Children[0], Cells[cellID].Children[1], Cells[cellID].Children[2], Cells[cellID].Children[3], edgeIDX};
-
-			// Subdivide cells
-			const int16 childSize = Cells[cellID].Size >> 1;	// TODO - need to ensure this never gets smaller than the minimum size (1). Will also need offsets fixed
-			for(int c = 0; c < 4; ++c)
+			// Rare, but long edges (e.g. simplified ones) can crowd more than 4 edges into a single source pixel
+			uint32 overflowIdx = cell.Overflow;
+			if(overflowIdx == FCell::INVALID)
 			{
-				const int16 childX = Cells[cellID].MinX + ((c & 1) ? childSize : 0);
-				const int16 childY = Cells[cellID].MinY + ((c > 1) ? childSize : 0);
-				Cells[cellID].Children[c] = Cells.Add({childX, childY, childSize});
+				overflowIdx = cells.Add({cell.MinX, cell.MinY, cell.Size});
+				cells[cellID].Overflow = overflowIdx;
 			}
-			Cells[cellID].bChildCells = true;
-			Cells[cellID].NumChildren = 4;
+
+			AddItem(cells, edges, overflowIdx, edgeData, edgeIDX);
+		}
+		else if(cells[cellID].NumChildren == 4)
+		{
+			// Need to reposition all of the 5 children (4 existing and 1 new);
+			const uint32 childEdgeIDXs[5] = {cells[cellID].Children[0], cells[cellID].Children[1], cells[cellID].Children[2], cells[cellID].Children[3], edgeIDX};
+
+			Subdivide(cells, cellID);
 
 			for(int i = 0; i < 5; ++i)
 			{
-				const uint16 childEdgeIDX = childEdgeIDXs[i];
-				const FEdgeData childEdge = Edges[childEdgeIDX];
+				const uint32 childEdgeIDX = childEdgeIDXs[i];
+				const FEdgeData childEdge = edges[childEdgeIDX];
 				for(int c = 0; c < 4; ++c)
 				{
 					// note - our edge may intersect multiple cells, if it crosses cell boundaries. This is fine
-					uint16 childCellIDX = Cells[cellID].Children[c];
-					const FCell& childCell = Cells[childCellIDX];
+					uint32 childCellIDX = cells[cellID].Children[c];
+					const FCell& childCell = cells[childCellIDX];
 					if(TestIntersection(childCell, childEdge))
-						AddItem(childCellIDX, childEdge, childEdgeIDX);
+						AddItem(cells, edges, childCellIDX, childEdge, childEdgeIDX);
 				}
 			}
 		}
 		else
 		{
-			auto& mutableCell = Cells[cellID];
+			auto& mutableCell = cells[cellID];
 			mutableCell.Children[mutableCell.NumChildren] = edgeIDX;
 			mutableCell.NumChildren++;
 		}
 	}
 
-	bool FQuadTree::FindDistance(const FCell& cell, FSearchContext& context) const
+	void FQuadTree::FreezeCell(const FCell& cell, uint32 frozenCellIdx)
 	{
-		bool anyFound = false;
+		FFrozenCell frozenCell;
+		frozenCell.MinX = cell.MinX;
+		frozenCell.MinY = cell.MinY;
+		frozenCell.MaxX = cell.MinX + cell.Size;
+		frozenCell.MaxY = cell.MinY + cell.Size;
+		frozenCell.NumChildren = cell.NumChildren;
+		frozenCell.bChildCells = cell.bChildCells;
+
 		if(cell.bChildCells)
 		{
-			// Quick and dirty check to see which quadrant to search in first, with the hope of finding an edge in there that makes the other quadrants skippable in broadphase
-			// Seems to shave around 15% total search time (depending on asset). Maybe worth investigating improved patterns, but expect diminishing returns
-			const bool toRight = context.P.X > cell.MinX + cell.Size;
-			const bool below = context.P.Y > cell.MinY + cell.Size;
-			const int firstCell = (toRight ? 1 : 0) + (below ? 2 : 0);
+			// Reserve all 4 children before descending, so siblings are adjacent and each subtree follows its parent's sibling block
+			frozenCell.FirstChild = FrozenCells.AddDefaulted(4);
+			FrozenCells[frozenCellIdx] = frozenCell;
 
 			for(int i = 0; i < 4; ++i)
-			{
-				int cellIndex = (firstCell + i) % 4;
-				const uint16 childCellId = cell.Children[cellIndex];
-				check(childCellId != FCell::INVALID);
-
-				const FCell& childCell = Cells[childCellId];
-				// NOTE: around 75% hitrate here (prior to testing num children). Branch prediciton doing nothing for us though
-				if(childCell.NumChildren > 0 && TestIntersection(childCell, context))
-					anyFound |= FindDistance(childCell, context);
-			}
+				FreezeCell(Cells[cell.Children[i]], frozenCell.FirstChild + i);
 		}
-		else	// Children are leaf nodes, so just to a distance check against them
+		else
 		{
-			bool updateBounds = false;
-			for(int i = 0; i < cell.NumChildren; ++i)
+			// Overflowing leaves are merged back into a single frozen leaf
+			TArray<uint32, TInlineAllocator<LeafWidth>> leafEdges;
+			for(const FCell* leaf = &cell; leaf; leaf = leaf->Overflow != FCell::INVALID ? &Cells[leaf->Overflow] : nullptr)
+				leafEdges.Append(leaf->Children, leaf->NumChildren);
+
+			frozenCell.NumChildren = leafEdges.Num();
+			frozenCell.FirstChild = LeafP1X.Num();
+			FrozenCells[frozenCellIdx] = frozenCell;
+
+			if(leafEdges.Num() == 0)
+				return;
+
+			// Padding to a whole number of vectors repeats the first edge, which cannot change the minimum distance found in the leaf
+			static_assert(UE_ARRAY_COUNT(cell.Children) == LeafWidth);
+			const int32 numLanes = FMath::DivideAndRoundUp(leafEdges.Num(), LeafWidth) * LeafWidth;
+			for(int i = 0; i < numLanes; ++i)
 			{
-				const uint16 foundEdgeId = cell.Children[i];
-				const FEdgeData& foundEdge = Edges[foundEdgeId];
+				const FEdgeData& edge = Edges[leafEdges[i < leafEdges.Num() ? i : 0]];
+				LeafP1X.Add(edge.P1.X);
+				LeafP1Y.Add(edge.P1.Y);
+				LeafP2X.Add(edge.P2.X);
+				LeafP2Y.Add(edge.P2.Y);
+			}
+		}
+	}
 
-				// NOTE: broad phase check against edges is not worth it. probably due to the cell based checks doing good enough culling
-				// Also would require moving the update search bounds back inside the loop, and that optimisation one is actually shaving time off
-				// if(!TestIntersection(context, foundEdge))
-				// 	continue;
+	void FQuadTree::FindLeafDistance(const FFrozenCell& cell, FSearchContext& context) const
+	{
+		context.NumEdgesTested += cell.NumChildren;
 
-				anyFound = true;
+		const VectorRegister4Float pX = VectorSetFloat1(context.P.X);
+		const VectorRegister4Float pY = VectorSetFloat1(context.P.Y);
 
-				const FVector2f& closestPointOnEdge = Utils::ClosestPointOnSegment2D(context.P, foundEdge.P1, foundEdge.P2);
-				const float foundDistanceSq = FVector2f::DistSquared(context.P, closestPointOnEdge);
+		// Leaves only hold more than one vector of edges if they overflowed
+		for(uint32 firstEdge = cell.FirstChild; firstEdge < cell.FirstChild + cell.NumChildren; firstEdge += LeafWidth)
+			FindLeafDistance(firstEdge, pX, pY, context);
+	}
 
-				if(foundDistanceSq < context.ClosestDistanceSq)
-				{
-					context.ClosestDistanceSq = foundDistanceSq;
-					updateBounds = true;
-				}
-			}
-			if(updateBounds)
-			 	context.UpdateSearchBounds(FMath::Sqrt(context.ClosestDistanceSq));
+	void FQuadTree::FindLeafDistance(uint32 firstEdge, const VectorRegister4Float& pX, const VectorRegister4Float& pY, FSearchContext& context) const
+	{
+		// Vectorised Utils::ClosestPointOnSegment2D, testing LeafWidth edges at once
+		const VectorRegister4Float p1X = VectorLoad(LeafP1X.GetData() + firstEdge);
+		const VectorRegister4Float p1Y = VectorLoad(LeafP1Y.GetData() + firstEdge);
+		const VectorRegister4Float segmentX = VectorSubtract(VectorLoad(LeafP2X.GetData() + firstEdge), p1X);
+		const VectorRegister4Float segmentY = VectorSubtract(VectorLoad(LeafP2Y.GetData() + firstEdge), p1Y);
+		const VectorRegister4Float toPointX = VectorSubtract(pX, p1X);
+		const VectorRegister4Float toPointY = VectorSubtract(pY, p1Y);
+
+		const VectorRegister4Float dot1 = VectorMultiplyAdd(toPointX, segmentX, VectorMultiply(toPointY, segmentY));
+		const VectorRegister4Float dot2 = VectorMultiplyAdd(segmentX, segmentX, VectorMultiply(segmentY, segmentY));
+
+		// Clamping replaces the start / end point branches. Zero length edges have dot1 == 0, so the small divisor leaves them at their start point
+		const VectorRegister4Float t = VectorMin(VectorMax(VectorDivide(dot1, VectorMax(dot2, VectorSetFloat1(UE_SMALL_NUMBER))), VectorZeroFloat()), VectorOneFloat());
+
+		const VectorRegister4Float deltaX = VectorSubtract(pX, VectorMultiplyAdd(segmentX, t, p1X));
+		const VectorRegister4Float deltaY = VectorSubtract(pY, VectorMultiplyAdd(segmentY, t, p1Y));
+		const VectorRegister4Float distancesSq = VectorMultiplyAdd(deltaX, deltaX, VectorMultiply(deltaY, deltaY));
+
+		alignas(16) float leafDistancesSq[LeafWidth];
+		VectorStoreAligned(distancesSq, leafDistancesSq);
+		const float foundDistanceSq = FMath::Min(FMath::Min(leafDistancesSq[0], leafDistancesSq[1]), FMath::Min(leafDistancesSq[2], leafDistancesSq[3]));
+
+		if(foundDistanceSq < context.ClosestDistanceSq)
+		{
+			int32 nearestLane = 0;
+			while(leafDistancesSq[nearestLane] != foundDistanceSq)
+				++nearestLane;
+
+			context.ClosestDistanceSq = foundDistanceSq;
+			context.NearestEdge = firstEdge + nearestLane;
+			context.UpdateSearchBounds(FMath::Sqrt(foundDistanceSq));
 		}
+	}
 
-		return anyFound;
+	void FQuadTree::FindEdgeDistance(int32 leafEdgeIdx, FSearchContext& context) const
+	{
+		const FVector2f& closestPointOnEdge = Utils::ClosestPointOnSegment2D(context.P, FVector2f(LeafP1X[leafEdgeIdx], LeafP1Y[leafEdgeIdx]), FVector2f(LeafP2X[leafEdgeIdx], LeafP2Y[leafEdgeIdx]));
+		const float foundDistanceSq = FVector2f::DistSquared(context.P, closestPointOnEdge);
+
+		++context.NumEdgesTested;
+		if(foundDistanceSq < context.ClosestDistanceSq)
+		{
+			context.ClosestDistanceSq = foundDistanceSq;
+			context.NearestEdge = leafEdgeIdx;
+			context.UpdateSearchBounds(FMath::Sqrt(foundDistanceSq));
+		}
 	}
 
 	FString FQuadTree::ToString(const FCell& cell, const FString& indentString) const
@@ -229,6 +503,9 @@ namespace RTM::SDF
 				FEdgeData edge = Edges[cell.Children[i]];
 				cellString += FString::Printf(TEXT("\n%sleaf [%d,%d][%d,%d]"), *childIndent, edge.MinX, edge.MinY, edge.MaxX, edge.MaxY);
 			}
+
+			if(cell.Overflow != FCell::INVALID)
+				cellString += FString(TEXT("\n")) + ToString(Cells[cell.Overflow], indentString);
 		}
 		return cellString;
 	}
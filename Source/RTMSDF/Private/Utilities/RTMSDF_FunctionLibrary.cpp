@@ -40,7 +40,9 @@ namespace RTM::SDF::FunctionLibraryStatics
 	static bool IsSingleChannelSDFTexture(ERTMSDF_SDFFormat format)
 	{
 		return format == ERTMSDF_SDFFormat::SingleChannel
-			|| format == ERTMSDF_SDFFormat::SingleChannelPseudo;
+			|| format == ERTMSDF_SDFFormat::SingleChannelPseudo
+			|| format == ERTMSDF_SDFFormat::SingleChannel16
+			|| format == ERTMSDF_SDFFormat::SingleChannelHalf;
 	}
 
 	static bool IsMSDFTexture(ERTMSDF_SDFFormat format)
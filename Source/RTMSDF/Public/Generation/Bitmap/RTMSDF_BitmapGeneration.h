@@ -3,16 +3,24 @@
 #pragma once
 #include "CoreMinimal.h"
 
+enum class ERTMSDF_BitmapDistanceEngine : uint8;
+
 namespace RTM::SDF
 {
 	struct FSDFBufferDef;
 	struct FSDFBufferMapping;
 	struct FQuadTree;
+	struct FDistanceTransform;
 
 	RTMSDF_API void SetChannelUniformValue(uint8* buffer, const FSDFBufferDef& bufferDef, uint8 channelOffset, uint8 value);
 	RTMSDF_API void CopyChannelValues(uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8 sourceChannelOffset, uint8* targetBuffer, const FSDFBufferDef& targetBufferDef, uint8 targetChannelOffset);
-	RTMSDF_API bool CreateDistanceField(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping);
-	RTMSDF_API bool FindIntersections(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, float* outIntersectionBuffer, const FSDFBufferDef& intersectionBufferDef, int channelOffset, uint32& outNumIntersections);
-	RTMSDF_API bool PopulateEdgeTree(const float* intersectionBuffer, const FSDFBufferDef& intersectionBufferDef, FQuadTree& tree);
-	RTMSDF_API void FindDistances(const FQuadTree& tree, const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping);
+	RTMSDF_API bool CreateDistanceField(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping, ERTMSDF_BitmapDistanceEngine engine);
+	RTMSDF_API bool CreateDistanceFields(uint8* const sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const TArray<FSDFBufferMapping>& mappings, ERTMSDF_BitmapDistanceEngine engine, TArray<bool>& outSuccess, int tileSize = 0, int searchTileSize = 0, float edgeTolerance = 0.0f);
+	RTMSDF_API int FindBestSearchTileSize();
+	RTMSDF_API bool FindEdges(const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, int channelOffset, TArray<FVector2f>& outEdgePoints);
+	RTMSDF_API bool TraceContours(const TArray<FVector2f>& edgePoints, float tolerance, TArray<TArray<FVector2f>>& outPolylines);
+	RTMSDF_API bool PopulateEdgeTree(const TArray<FVector2f>& edgePoints, FQuadTree& tree);
+	RTMSDF_API bool PopulateDistanceTransform(const TArray<FVector2f>& edgePoints, FDistanceTransform& distanceTransform);
+	RTMSDF_API void FindDistances(const FQuadTree& tree, const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping, int searchTileSize = 0);
+	RTMSDF_API void FindDistances(const FDistanceTransform& distanceTransform, const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, uint8* outSDFBuffer, const FSDFBufferDef& sdfBufferDef, const FSDFBufferMapping& mapping, int searchTileSize = 0);
 }
@@ -3,6 +3,7 @@
 #pragma once
 #include "Generation/Common/RTMSDF_CommonGenerationSettings.h"
 #include "Generation/Common/RTMSDF_SDFFormat.h"
+#include "Generation/SVG/RTM_MSDFEnums.h"
 #include "RTMSDF_BitmapGenerationSettings.generated.h"
 
 UENUM(DisplayName = "Bitmap Per Channel Behavior [RTMSDF]")
@@ -28,6 +29,24 @@ enum class ERTMSDF_RGBAMode : uint8
 	PreserveRGB,
 };
 
+UENUM(DisplayName = "Bitmap Distance Engine [RTMSDF]")
+enum class ERTMSDF_BitmapDistanceEngine : uint8
+{
+	/* Searches a quadtree of the source edges from every output pixel
+	 * Search time grows with the distance range, so large ranges on large sources can be slow */
+	EdgeTree,
+
+	/* Separable euclidean distance transform over the source, refined to the nearest subpixel edge
+	 * Generation time does not depend on the distance range, recommended for large sources and ranges */
+	DistanceTransform,
+
+	/* Distance Transform with edges placed from the coverage and gradient of anti-aliased source pixels, rather than by interpolating between pixels
+	 * Much more accurate for anti-aliased sources, so smaller sources give the same quality. Hard edged sources have the same edges as Distance Transform, but inside and outside are sampled from the source rather than found from the edges, so pixels beside an edge may differ */
+	AntiAliasedDistanceTransform UMETA(DisplayName="Anti-Aliased Distance Transform"),
+
+	MAX UMETA(Hidden),
+};
+
 UENUM(meta=(Bitflags, UseEnumValuesAsMaskValuesInEditor="true"))
 enum class ERTMSDF_Channels : uint8
 {
@@ -53,7 +72,9 @@ struct RTMSDF_API FRTMSDF_BitmapGenerationSettings : public FRTMSDF_CommonGenera
 	UPROPERTY()
 	int VersionNumber = 0;
 
-	UPROPERTY(EditAnywhere, Category="ImportNew", meta=(EditCondition="NumSourceChannels > 1", HideEditConditionToggle, ValidEnumValues="SingleChannel, SeparateChannels"))
+	/* Multichannel formats trace the contours of the source channel into lines and curves, then generate from those as for SVGs
+	 * Separate Channels is not available for single channel sources, which import it as Single Channel */
+	UPROPERTY(EditAnywhere, Category="ImportNew", meta=(ValidEnumValues="SingleChannel, SingleChannel16, SingleChannelHalf, SeparateChannels, Multichannel, MultichannelPlusAlpha"))
 	ERTMSDF_SDFFormat Format = ERTMSDF_SDFFormat::SingleChannel;
 
 	// How to handle the red channel from the source data
@@ -74,13 +95,39 @@ struct RTMSDF_API FRTMSDF_BitmapGenerationSettings : public FRTMSDF_CommonGenera
 
 	/* Which channel from the source data should be used to generate the SDF
 	 * Unused channels will be discarded as this is a single-channel SDF */
-	UPROPERTY(EditAnywhere, Category="Import", meta=(EditCondition="NumSourceChannels > 1 && Format == ERTMSDF_SDFFormat::SingleChannel", EditConditionHides, DisplayName="Source Channel"))
+	UPROPERTY(EditAnywhere, Category="Import", meta=(EditCondition="NumSourceChannels > 1 && Format != ERTMSDF_SDFFormat::SeparateChannels", EditConditionHides, DisplayName="Source Channel"))
 	ERTMSDF_Channels SDFChannel = ERTMSDF_Channels::Red;
 
+	/* Maximum angle to treat a corner of the traced contours as a corner for the sake of edge coloring / preserving sharpness */
+	UPROPERTY(EditAnywhere, Category="Import", meta=(EditCondition="Format == ERTMSDF_SDFFormat::Multichannel || Format == ERTMSDF_SDFFormat::MultichannelPlusAlpha", EditConditionHides, UIMin=1, ClampMin=1, UIMax=179, ClampMax=179))
+	float MaxCornerAngle = 150.0f;
+
+	UPROPERTY(EditAnywhere, Category="Import", meta=(EditCondition="Format == ERTMSDF_SDFFormat::Multichannel || Format == ERTMSDF_SDFFormat::MultichannelPlusAlpha", EditConditionHides))
+	ERTMSDF_MSDFErrorCorrectionMode ErrorCorrectionMode = ERTMSDF_MSDFErrorCorrectionMode::EdgePriorityFull;
+
+	/* How far in source pixels the traced contours may move when fitted with lines and curves. Larger values give fewer, smoother edges */
+	UPROPERTY(EditAnywhere, Category="Import", AdvancedDisplay, meta=(EditCondition="Format == ERTMSDF_SDFFormat::Multichannel || Format == ERTMSDF_SDFFormat::MultichannelPlusAlpha", EditConditionHides, UIMin=0, ClampMin=0, UIMax=1))
+	float ContourFitTolerance = 0.25f;
+
 	/* Output size of generated SDF texture - for non-square textures this will be the shortest edge */
 	UPROPERTY(EditAnywhere, Category="Import", meta=(EditCondition="true", EditConditionHides, UIMin=8, ClampMin=8))
 	int TextureSize = 64;
 
+	/* Algorithm used to find the distance to edges in the source texture
+	 * Distance Transform finds the same distances as Edge Tree, but is much faster for large distance ranges. Not used by Multichannel formats */
+	UPROPERTY(EditAnywhere, Category="Import", AdvancedDisplay, meta=(EditCondition="Format != ERTMSDF_SDFFormat::Multichannel && Format != ERTMSDF_SDFFormat::MultichannelPlusAlpha", EditConditionHides))
+	ERTMSDF_BitmapDistanceEngine DistanceEngine = ERTMSDF_BitmapDistanceEngine::EdgeTree;
+
+	/* Generates the SDF in square tiles of this many output pixels, each using only the nearby part of the source. Limits the working memory of edge searches when importing very large sources
+	 * The whole source and the whole output are still held in memory. 0 generates the whole SDF at once. Not used by Multichannel formats */
+	UPROPERTY(EditAnywhere, Category="Import", AdvancedDisplay, meta=(EditCondition="Format != ERTMSDF_SDFFormat::Multichannel && Format != ERTMSDF_SDFFormat::MultichannelPlusAlpha", EditConditionHides, UIMin=0, ClampMin=0))
+	int GenerationTileSize = 0;
+
+	/* Merges runs of nearly straight source edges, moving them by at most this many source pixels. Fewer edges make Edge Tree generation faster, at the cost of up to this much distance error
+	 * 0 keeps every edge as found. Has no effect on the Distance Transform engine or Multichannel formats */
+	UPROPERTY(EditAnywhere, Category="Import", AdvancedDisplay, meta=(EditCondition="Format != ERTMSDF_SDFFormat::Multichannel && Format != ERTMSDF_SDFFormat::MultichannelPlusAlpha", EditConditionHides, UIMin=0, ClampMin=0, UIMax=0.5))
+	float EdgeSimplificationTolerance = 0.0f;
+
 	virtual int GetTextureSize() const override { return TextureSize; }
 	virtual ERTMSDF_SDFFormat GetFormat() const override { return Format; }
 
@@ -0,0 +1,48 @@
+﻿// Copyright (c) Richard Meredith AB. All Rights Reserved
+
+#pragma once
+#include "CoreMinimal.h"
+
+namespace RTM::SDF
+{
+	struct FSearchContext;
+
+	/* Alternative to FQuadTree for finding distances to the edges of a bitmap.
+	 * Edges are binned into the unit cells of the source grid, then a separable exact euclidean distance transform finds the nearest cell containing an edge for every cell.
+	 * Queries start from that nearest cell, then only test the thin ring of cells beyond it whose edges could still be nearer, so results are exact and the cost of a query grows only slowly with distance */
+	struct RTMSDF_API FDistanceTransform
+	{
+		int32 Width = 0;
+		int32 Height = 0;
+
+		// Edge end points, stored in pairs
+		TArray<FVector2f> EdgePoints;
+
+		// Index of the first edge in each cell, plus one extra entry for the end of the last cell
+		TArray<int32> CellEdgeStart;
+
+		// Index of the nearest cell that contains any edges, for each cell. INDEX_NONE if there are no edges at all
+		TArray<int32> NearestEdgeCell;
+
+		// Furthest distance of any edge point from the centre of the cell its edge is binned into
+		float MaxEdgeReach = 0.0f;
+
+		FDistanceTransform(int32 width, int32 height, int32 reserveEdges = 0);
+
+		void AddItem(const FVector2f& edgePointA, const FVector2f& edgePointB);
+		void Build();
+		bool FindDistance(FSearchContext& context) const;
+		bool FindDistance(TArrayView<FSearchContext> contexts) const;
+
+	private:
+		FDistanceTransform() = default;
+
+		void BuildCellEdges();
+		void BuildColumn(int32 x, TArray<int32>& outNearestRows) const;
+		void BuildRow(int32 y, const TArray<int32>& nearestRows);
+
+		bool SearchCell(int32 cellIdx, FSearchContext& context) const;
+		FIntPoint GetCell(const FVector2f& pos) const;
+		int32 NumEdges() const { return EdgePoints.Num() / 2; }
+	};
+}
@@ -2,22 +2,26 @@
 
 #pragma once
 #include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
 
 namespace RTM::SDF
 {
 	struct FCell
 	{
-		int16 MinX = 0;
-		int16 MinY = 0;
-		int16 Size = 0;		// TODO - consider if size should be unsigned?
+		int32 MinX = 0;
+		int32 MinY = 0;
+		int32 Size = 0;		// TODO - consider if size should be unsigned?
 		bool bChildCells = false;
 		uint8 NumChildren = 0;
 
-		uint16 Children[4] = {INVALID, INVALID, INVALID, INVALID};
+		uint32 Children[4] = {INVALID, INVALID, INVALID, INVALID};
 
-		static constexpr uint16 INVALID = ~0;
+		// Leaves of the minimum size can't be subdivided, so once full they continue into this leaf instead
+		uint32 Overflow = INVALID;
 
-		constexpr FCell(int16 minX, int16 minY, int16 size)
+		static constexpr uint32 INVALID = ~0;
+
+		constexpr FCell(int32 minX, int32 minY, int32 size)
 			: MinX(minX)
 			, MinY(minY)
 			, Size(size)
@@ -27,12 +31,24 @@ namespace RTM::SDF
 		FCell() = default;
 	};
 
+	// Read-only copy of an FCell, laid out so that each cell's 4 children are contiguous and subtrees are stored depth first
+	struct FFrozenCell
+	{
+		int32 MinX = 0;
+		int32 MinY = 0;
+		int32 MaxX = 0;
+		int32 MaxY = 0;
+		uint32 FirstChild = 0;		// Index of the first child cell if bChildCells, otherwise the first edge in the leaf edge arrays
+		uint32 NumChildren = 0;		// Leaves merge their overflow leaves, so dense sources can hold any number of edges in one
+		bool bChildCells = false;
+	};
+
 	struct FEdgeData
 	{
-		uint16 MinX = 0;
-		uint16 MinY = 0;
-		uint16 MaxX = 0;
-		uint16 MaxY = 0;
+		int32 MinX = 0;
+		int32 MinY = 0;
+		int32 MaxX = 0;
+		int32 MaxY = 0;
 		FVector2f P1 = FVector2f(ForceInitToZero);
 		FVector2f P2 = FVector2f(ForceInitToZero);
 
@@ -56,22 +72,37 @@ namespace RTM::SDF
 	{
 		FVector2f P = FVector2f(ForceInitToZero);
 		float ClosestDistanceSq = FLT_MAX;
-		int16 MinX = 0;
-		int16 MinY = 0;
-		int16 MaxX = 0;
-		int16 MaxY = 0;
+		int32 MinX = 0;
+		int32 MinY = 0;
+		int32 MaxX = 0;
+		int32 MaxY = 0;
+
+		// Index of the nearest edge found so far, in the searcher's own edge order. If set before searching, this edge is tested first
+		int32 NearestEdge = INDEX_NONE;
 
-		FSearchContext(FVector2f searchLocation, float maxDistance)
+		// Search statistics, accumulated over every search made with this context
+		uint32 NumCellsVisited = 0;
+		uint32 NumEdgesTested = 0;
+
+		FSearchContext(FVector2f searchLocation, float maxDistance, int32 nearestEdge = INDEX_NONE)
 			: P(searchLocation)
+			, NearestEdge(nearestEdge)
 		{
 			ClosestDistanceSq = maxDistance * maxDistance;
 			UpdateSearchBounds(maxDistance);
 		}
 
+		// Moves the search to a new location, keeping the closest distance found so far as the search radius
+		void MoveTo(const FVector2f& searchLocation)
+		{
+			P = searchLocation;
+			UpdateSearchBounds(FMath::Sqrt(ClosestDistanceSq));
+		}
+
 		void UpdateSearchBounds(float maxDistance)
 		{
 			check(maxDistance >= 0);
-			int16 searchExtent = FMath::CeilToInt(maxDistance);
+			int32 searchExtent = FMath::CeilToInt(maxDistance);
 			MinX = FMath::FloorToInt(P.X) - searchExtent;
 			MinY = FMath::FloorToInt(P.Y) - searchExtent;
 			MaxX = FMath::CeilToInt(P.X) + searchExtent;
@@ -88,10 +119,32 @@ namespace RTM::SDF
 		TArray<FCell> Cells;
 		TArray<FEdgeData> Edges;
 
-		FQuadTree(int16 sizeX, int16 sizeY, size_t reserveEdges = 0, size_t reserveCells = 0);
+		// Search data, populated by Freeze(). Leaf edges are duplicated into every leaf they overlap so that each leaf's edges are contiguous
+		// Every leaf is padded to LeafWidth edges by repeating its first edge, so a whole leaf can be tested in a single vector operation
+		TArray<FFrozenCell> FrozenCells;
+		TArray<float> LeafP1X;
+		TArray<float> LeafP1Y;
+		TArray<float> LeafP2X;
+		TArray<float> LeafP2Y;
+
+		static constexpr int32 LeafWidth = 4;
+		static constexpr int32 MaxPacketSize = 4;
+
+		FQuadTree(int32 sizeX, int32 sizeY, size_t reserveEdges = 0, size_t reserveCells = 0);
 
 		void AddItem(const FVector2f& edgePointA, const FVector2f& edgePointB);
+
+		// Adds edges stored as pairs of end points. Large sets of edges added to an empty tree are built in parallel
+		void AddItems(const TArray<FVector2f>& edgePoints);
+
+		// Builds the search data once all items have been added. Must be called before FindDistance, and again if any more items are added
+		void Freeze();
+		bool IsFrozen() const { return FrozenCells.Num() > 0; }
+
 		bool FindDistance(FSearchContext& context) const;
+
+		// Searches for several nearby points at once, sharing a single traversal of the tree. Results are identical to searching for each point individually
+		bool FindDistance(TArrayView<FSearchContext> contexts) const;
 		FString ToString() const;
 
 		// TODO - remove once sure of branch prediction inefficacy
@@ -101,8 +154,12 @@ namespace RTM::SDF
 	private:
 		FQuadTree() = default;
 
-		void AddItem(const uint16 cellID, const FEdgeData& edgeData, uint16 edgeIDX);
-		bool FindDistance(const FCell& cell, FSearchContext& context) const;
+		static void AddItem(TArray<FCell>& cells, const TArray<FEdgeData>& edges, const uint32 cellID, const FEdgeData& edgeData, uint32 edgeIDX);
+		void AddItemsParallel(const TArray<FVector2f>& edgePoints);
+		void FreezeCell(const FCell& cell, uint32 frozenCellIdx);
+		void FindLeafDistance(const FFrozenCell& cell, FSearchContext& context) const;
+		void FindLeafDistance(uint32 firstEdge, const VectorRegister4Float& pX, const VectorRegister4Float& pY, FSearchContext& context) const;
+		void FindEdgeDistance(int32 leafEdgeIdx, FSearchContext& context) const;
 		FString ToString(const FCell& cell, const FString& indentString) const;
 	};
 }
@@ -8,12 +8,12 @@ namespace RTM::SDF
 {
 	struct FSDFBufferDef
 	{
-		uint16 Width = 0;
-		uint16 Height = 0;
+		int32 Width = 0;
+		int32 Height = 0;
 		uint8 NumChannels = 0;
 		ETextureSourceFormat Format = static_cast<ETextureSourceFormat>(0); // TSF_Invalid;
 
-		size_t GetBufferLen() const { return Width * Height * NumChannels; }	// todo - * type ?
+		size_t GetBufferLen() const { return static_cast<size_t>(Width) * Height * NumChannels; }	// in channels - see GetBufferSize() for bytes
 	};
 
 	struct FSDFBufferMapping
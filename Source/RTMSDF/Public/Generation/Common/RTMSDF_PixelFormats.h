@@ -0,0 +1,132 @@
+﻿// Copyright (c) Richard Meredith AB. All Rights Reserved
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/Texture.h"
+#include "Generation/Common/RTMSDF_Buffers.h"
+#include "Generation/Common/RTMSDF_SDFFormat.h"
+#include "Math/Float16.h"
+
+// Single channel half float texture sources were added in UE 5.1
+#define RTMSDF_WITH_R16F_SOURCE (ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1))
+
+namespace RTM::SDF
+{
+	/* Values of a single channel, in the channel's own units
+	 * Every channel type thresholds its edges at the same point as 8 bit sources, 127 / 255
+	 * FromUnit quantizes a value between 0 and 1 the same way for every type, so SDFs keep their edge at 0.5 whatever their precision */
+	template<typename TChannelType>
+	struct TChannelTraits;
+
+	template<>
+	struct TChannelTraits<uint8>
+	{
+		static constexpr float Threshold = 127.0f;
+		static constexpr float MaxValue = 255.0f;
+		static float ToFloat(uint8 value) { return value; }
+		static uint8 FromUnit(float value) { return FMath::Clamp(FMath::FloorToInt(value * 255.0f), 0, 255); }
+	};
+
+	template<>
+	struct TChannelTraits<uint16>
+	{
+		static constexpr float Threshold = 127.0f * 257.0f;
+		static constexpr float MaxValue = 65535.0f;
+		static float ToFloat(uint16 value) { return value; }
+		static uint16 FromUnit(float value) { return FMath::Clamp(FMath::FloorToInt(value * 65535.0f), 0, 65535); }
+	};
+
+	template<>
+	struct TChannelTraits<FFloat16>
+	{
+		static constexpr float Threshold = 127.0f / 255.0f;
+		static constexpr float MaxValue = 1.0f;
+		static float ToFloat(FFloat16 value) { return value.GetFloat(); }
+		static FFloat16 FromUnit(float value) { return FFloat16(FMath::Clamp(value, 0.0f, 1.0f)); }
+	};
+
+	// Layout of a source pixel, known at compile time so that kernels reading it have fixed channel strides
+	template<typename TChannelType, int32 InNumChannels>
+	struct TPixelFormat
+	{
+		using TChannel = TChannelType;
+		using FTraits = TChannelTraits<TChannelType>;
+		static constexpr int32 NumChannels = InNumChannels;
+
+		// Value between 0 and 1, clamped as float channels may hold values outside that range
+		static float ToUnit(TChannel value) { return FMath::Clamp(FTraits::ToFloat(value) / FTraits::MaxValue, 0.0f, 1.0f); }
+	};
+
+	using FPixelFormatG8 = TPixelFormat<uint8, 1>;
+	using FPixelFormatBGRA8 = TPixelFormat<uint8, 4>;
+	using FPixelFormatG16 = TPixelFormat<uint16, 1>;
+	using FPixelFormatRGBA16 = TPixelFormat<uint16, 4>;
+	using FPixelFormatRGBA16F = TPixelFormat<FFloat16, 4>;
+	using FPixelFormatR16F = TPixelFormat<FFloat16, 1>;
+
+	/* Calls visitor with a default constructed TPixelFormat matching the buffer's format, and returns false if the format isn't supported
+	 * Buffers without a format are 8 bit, as they were before formats were tracked */
+	template<typename TVisitor>
+	bool VisitPixelFormat(const FSDFBufferDef& bufferDef, TVisitor&& visitor)
+	{
+		auto visit = [&bufferDef, &visitor](auto pixelFormat)
+		{
+			if(!ensureAlwaysMsgf(bufferDef.NumChannels == decltype(pixelFormat)::NumChannels, TEXT("Buffer has %d channels, but its format has %d"), bufferDef.NumChannels, decltype(pixelFormat)::NumChannels))
+				return false;
+
+			visitor(pixelFormat);
+			return true;
+		};
+
+		switch(bufferDef.Format)
+		{
+			case TSF_G8: return visit(FPixelFormatG8());
+			case TSF_BGRA8:
+			case TSF_BGRE8: return visit(FPixelFormatBGRA8());
+			case TSF_G16: return visit(FPixelFormatG16());
+			case TSF_RGBA16: return visit(FPixelFormatRGBA16());
+			case TSF_RGBA16F: return visit(FPixelFormatRGBA16F());
+#if RTMSDF_WITH_R16F_SOURCE
+			case TSF_R16F: return visit(FPixelFormatR16F());
+#endif
+			case TSF_Invalid: return bufferDef.NumChannels == 1 ? visit(FPixelFormatG8()) : visit(FPixelFormatBGRA8());
+			default: return false;
+		}
+	}
+
+	inline int32 GetBytesPerChannel(const FSDFBufferDef& bufferDef)
+	{
+		switch(bufferDef.Format)
+		{
+			case TSF_G16:
+			case TSF_RGBA16:
+			case TSF_RGBA16F:
+#if RTMSDF_WITH_R16F_SOURCE
+			case TSF_R16F:
+#endif
+				return 2;
+			default: return 1;
+		}
+	}
+
+	// Size of the buffer in bytes, where GetBufferLen() is in channels
+	inline size_t GetBufferSize(const FSDFBufferDef& bufferDef)
+	{
+		return bufferDef.GetBufferLen() * GetBytesPerChannel(bufferDef);
+	}
+
+	// Texture source format that single channel SDFs of the given format are written to
+	inline ETextureSourceFormat GetSingleChannelSourceFormat(ERTMSDF_SDFFormat format)
+	{
+		switch(format)
+		{
+			case ERTMSDF_SDFFormat::SingleChannel16: return TSF_G16;
+#if RTMSDF_WITH_R16F_SOURCE
+			case ERTMSDF_SDFFormat::SingleChannelHalf: return TSF_R16F;
+#else
+			case ERTMSDF_SDFFormat::SingleChannelHalf: return TSF_G16;
+#endif
+			default: return TSF_G8;
+		}
+	}
+}
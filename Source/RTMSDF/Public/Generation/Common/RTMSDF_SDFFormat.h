@@ -22,6 +22,12 @@ enum class ERTMSDF_SDFFormat : uint8
 	// MSDF in RGBA with true SDF in the Alpha channel
 	MultichannelPlusAlpha,
 
+	// Traditional 'true' SDF, stored as 16 bit unsigned normalized values (G16) for finer distance steps than 8 bit
+	SingleChannel16,
+
+	// Traditional 'true' SDF, stored as 16 bit floats (R16F). Falls back to 16 bit unsigned normalized values before UE 5.1
+	SingleChannelHalf,
+
 	MAX UMETA(Hidden),
 
 	Invalid,
@@ -30,5 +36,7 @@ enum class ERTMSDF_SDFFormat : uint8
 inline bool IsSingleChannelFormat(ERTMSDF_SDFFormat format)
 {
 	return format == ERTMSDF_SDFFormat::SingleChannel
-		|| format == ERTMSDF_SDFFormat::SingleChannelPseudo;
+		|| format == ERTMSDF_SDFFormat::SingleChannelPseudo
+		|| format == ERTMSDF_SDFFormat::SingleChannel16
+		|| format == ERTMSDF_SDFFormat::SingleChannelHalf;
 }
\ No newline at end of file
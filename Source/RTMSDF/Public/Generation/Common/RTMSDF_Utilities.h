@@ -26,13 +26,14 @@ namespace RTM::SDF::Utils
 		return startPoint + segment * (dot1 / dot2);
 	}
 
-	static uint16 RoundUpToPow2(uint16 a)
+	static uint32 RoundUpToPow2(uint32 a)
 	{
 		a--;
 		a |= a >> 1;
 		a |= a >> 2;
 		a |= a >> 4;
 		a |= a >> 8;
+		a |= a >> 16;
 		a++;
 		return a;
 	}
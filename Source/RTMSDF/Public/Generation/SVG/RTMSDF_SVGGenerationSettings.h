@@ -17,7 +17,7 @@ struct RTMSDF_API FRTMSDF_SVGGenerationSettings : public FRTMSDF_CommonGeneratio
 	UPROPERTY()
 	int VersionNumber = 0;
 
-	UPROPERTY(EditAnywhere, Category="Import", meta=(ValidEnumValues="SingleChannel, SingleChannelPseudo, Multichannel, MultichannelPlusAlpha"))
+	UPROPERTY(EditAnywhere, Category="Import", meta=(ValidEnumValues="SingleChannel, SingleChannelPseudo, SingleChannel16, SingleChannelHalf, Multichannel, MultichannelPlusAlpha"))
 	ERTMSDF_SDFFormat Format = ERTMSDF_SDFFormat::MultichannelPlusAlpha;
 
 	/* Output size of generated SDF texture - for non-square textures this will be the shortest edge - recommend power of 2 sizes only */
@@ -43,6 +43,21 @@ struct RTMSDF_API FRTMSDF_SVGGenerationSettings : public FRTMSDF_CommonGeneratio
 	UPROPERTY(EditAnywhere, Category="Import", meta=(EditCondition="Format == ERTMSDFFormat::Multichannel || Format == ERTMSDFFormat::MultichannelPlusAlpha", DisplayAfter="InvertDistance", UIMin=1, ClampMin=1, UIMax=2, ClampMax=2))
 	double MinErrorImprovement = 1.11111111111111111;
 
+	/* Speed of finding the distance to curves in the SVG. Fast is much quicker for SVGs made mostly of curves (e.g. exported from Illustrator)
+	 * but may differ slightly from High far from tightly bent curves. Only used when the Use Compiled Shape editor setting is enabled */
+	UPROPERTY(EditAnywhere, Category="Import")
+	ERTMSDF_CurveDistanceQuality CurveDistanceQuality = ERTMSDF_CurveDistanceQuality::High;
+
+	/* Full distance checks during error correction only test the edges nearest to each texel, recorded during generation, instead of every edge in the shape
+	 * Much faster for SVGs with many edges, but the checks are approximate, so a few more or fewer texels may be corrected */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category="Import", meta=(EditCondition="Format == ERTMSDFFormat::Multichannel || Format == ERTMSDFFormat::MultichannelPlusAlpha", DisplayAfter="InvertDistance"))
+	bool bNearestEdgeErrorCorrection = false;
+
+	/* Evaluate distances in single precision, which is faster and stays well within one step of the 8 bit output
+	 * Only used for 8 bit formats - 16 bit and half float formats always generate in double precision */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category="Import", meta=(EditCondition="Format != ERTMSDFFormat::SingleChannel16 && Format != ERTMSDFFormat::SingleChannelHalf"))
+	bool bSinglePrecision = false;
+
 	virtual int GetTextureSize() const override { return TextureSize; }
 	virtual ERTMSDF_SDFFormat GetFormat() const override { return Format; }
 	void FixUpVersioning();
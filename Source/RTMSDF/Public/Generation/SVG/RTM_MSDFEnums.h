@@ -50,5 +50,17 @@ enum class ERTMSDF_MSDFErrorCorrectionMode : uint8
 	// Correct all artifacts. Full distance checks
 	IndiscriminateFull UMETA(DisplayName="Indiscriminate - Full"),
 
+	MAX UMETA(Hidden),
+};
+
+UENUM(DisplayName = "Curve Distance Quality [RTMSDF]")
+enum class ERTMSDF_CurveDistanceQuality : uint8
+{
+	// Searches every curve for its closest point from several evenly spaced points
+	High,
+
+	// Splits every curve into sections once, and only searches the sections that contain a closest point. Much faster for SVGs with many curves, but may differ slightly far from tight bends
+	Fast,
+
 	MAX UMETA(Hidden),
 };
\ No newline at end of file
@@ -9,6 +9,12 @@
 #include "Module/RTMSDFEditor.h"
 #include "Generation/Bitmap/RTMSDF_BitmapGeneration.h"
 #include "Generation/Common/RTMSDF_Buffers.h"
+#include "Generation/Common/RTMSDF_PixelFormats.h"
+#include "Settings/RTMSDF_PerUserEditorSettings.h"
+#include "MSDF/RTMSDF_MSDFGenerationHelpers.h"
+#include "MSDF/RTMSDF_MSDFTextureHelpers.h"
+#include "ChlumskyMSDFGen/Public/Core/msdfgen.h"
+#include "Core/SDFTransformation.h"
 
 namespace RTM::SDF::TexturePostProcess
 {
@@ -43,10 +49,18 @@ namespace RTM::SDF::TexturePostProcess
 				channelPositions.Append({ERTMSDF_Channels::Blue, ERTMSDF_Channels::Green, ERTMSDF_Channels::Red, ERTMSDF_Channels::Alpha});
 				return true;
 
+			case TSF_G16:
+#if RTMSDF_WITH_R16F_SOURCE
+			case TSF_R16F:
+#endif
+				channelPositions.Add(ERTMSDF_Channels::Red);
+				return true;
+
 			case TSF_RGBA16:
 			case TSF_RGBA16F:
-			case TSF_G16:
-				UE_LOG(RTMSDFEditor, Error, TEXT("Unsupported Source format - 16 bit formats not currently supported"));
+				channelPositions.Append({ERTMSDF_Channels::Red, ERTMSDF_Channels::Green, ERTMSDF_Channels::Blue, ERTMSDF_Channels::Alpha});
+				return true;
+
 			default:
 				UE_LOG(RTMSDFEditor, Error, TEXT("Unable to import file with texture format (ETextureSourceFormat)  = %d"), static_cast<int>(format));
 				return false;
@@ -85,6 +99,52 @@ namespace RTM::SDF::TexturePostProcess
 		return false;
 	}
 
+	// Traces the source channel into a shape, and generates from that the same way as an SVG. Replaces the locked source data, so unlocks it first
+	void PopulateMSDFFromBitmap(UTexture2D* texture, const uint8* mip, const FSDFBufferDef& sourceBufferDef, int sourceChannelIdx, const FRTMSDF_BitmapGenerationSettings& importerSettings)
+	{
+		using namespace msdfgen;
+		using namespace MSDFGenerationHelpers;
+
+		const uint64 cyclesStart = FPlatformTime::Cycles();
+
+		Shape shape;
+		const double angleThreshold = FMath::DegreesToRadians(importerSettings.MaxCornerAngle);
+		if(sourceChannelIdx != INDEX_NONE && CreateShape(mip, sourceBufferDef, sourceChannelIdx, importerSettings.ContourFitTolerance, angleThreshold, shape))
+			DoEdgeColoringDistance(shape, angleThreshold);
+		else
+			UE_LOG(RTMSDFEditor, Warning, TEXT("%s : No contours found in source channel - SDF will be empty"), ANSI_TO_TCHAR(__FUNCTION__));
+
+		// Traced shapes are generated as for SVGs, so the bitmap edge search settings and tiling don't apply
+		if(texture->AddressX == TA_Wrap || texture->AddressY == TA_Wrap)
+			UE_LOG(RTMSDFEditor, Warning, TEXT("%s : %s wraps, but Multichannel formats don't tile - edges across its seams will be missing"), ANSI_TO_TCHAR(__FUNCTION__), *texture->GetName());
+		if(importerSettings.DistanceEngine != ERTMSDF_BitmapDistanceEngine::EdgeTree || importerSettings.GenerationTileSize > 0 || importerSettings.EdgeSimplificationTolerance > 0.0f)
+			UE_LOG(RTMSDFEditor, Warning, TEXT("%s : Distance Engine, Generation Tile Size and Edge Simplification Tolerance are ignored by Multichannel formats"), ANSI_TO_TCHAR(__FUNCTION__));
+
+		const FVector2D sourceSize(sourceBufferDef.Width, sourceBufferDef.Height);
+		Vector2 sdfSize;
+		const SDFTransformation transformation = CalculateTransformation(Vector2(sourceSize.X, sourceSize.Y), importerSettings.TextureSize, importerSettings.bScaleToFitDistance, importerSettings.GetAbsoluteRange(sourceSize), sdfSize);
+
+		MSDFGeneratorConfig generatorConfig;
+		generatorConfig.overlapSupport = true;
+		if(const auto* editorSettings = GetDefault<URTMSDF_PerUserEditorSettings>())
+		{
+			generatorConfig.threadCount = editorSettings->MaxGenerationThreads;
+			generatorConfig.useEdgeIndex = editorSettings->bUseEdgeIndex;
+			generatorConfig.useCompiledShape = editorSettings->bUseCompiledShape;
+		}
+
+		ApplyErrorCorrectionModeTo(generatorConfig.errorCorrection, importerSettings.ErrorCorrectionMode);
+
+		const uint64 cyclesTraced = FPlatformTime::Cycles();
+
+		texture->Source.UnlockMip(0, 0, 0);
+		MSDFTextureHelpers::PopulateSDFTextureSourceData(importerSettings.Format, generatorConfig, sdfSize, shape, transformation, importerSettings.bInvertDistance, texture);
+
+		const uint64 cyclesEnd = FPlatformTime::Cycles();
+		UE_LOG(RTMSDFEditor, Verbose, TEXT("%s : %d contours - traced in %.2f ms, generated in %.2f ms"), ANSI_TO_TCHAR(__FUNCTION__), static_cast<int>(shape.contours.size()),
+			FPlatformTime::ToMilliseconds(cyclesTraced - cyclesStart), FPlatformTime::ToMilliseconds(cyclesEnd - cyclesTraced));
+	}
+
 	void PostProcessImportedTexture(UTexture2D* texture, FRTMSDFTextureSettingsCache& textureSettings, FRTMSDF_BitmapGenerationSettings& importerSettings, bool isReimport)
 	{
 		const uint64 cyclesStart = FPlatformTime::Cycles();
@@ -96,7 +156,6 @@ namespace RTM::SDF::TexturePostProcess
 
 		uint8* mip = texture->Source.LockMip(0, 0, 0);
 		const ETextureSourceFormat sourceFormat = texture->Source.GetFormat(0);
-		const int numSourceChannels = texture->Source.GetBytesPerPixel(0);		// TODO - this is currently ok because we are only supporting 8 bit source files
 		const int sourceWidth = texture->Source.GetSizeX();
 		const int sourceHeight = texture->Source.GetSizeY();
 		const FVector2D sourceSize(sourceWidth, sourceHeight);
@@ -109,7 +168,7 @@ namespace RTM::SDF::TexturePostProcess
 			return;
 		}
 
-		ensureAlways(numSourceChannels == sourceChannelColors.Num());
+		const int numSourceChannels = sourceChannelColors.Num();
 
 		if(!isReimport)
 		{
@@ -126,11 +185,15 @@ namespace RTM::SDF::TexturePostProcess
 		}
 
 		importerSettings.NumSourceChannels = numSourceChannels;
-		if(importerSettings.NumSourceChannels == 1)
+		if(importerSettings.NumSourceChannels == 1 && importerSettings.Format == ERTMSDF_SDFFormat::SeparateChannels)
+		{
+			// Every other format is available to single channel sources, but there is only one channel to separate
+			UE_LOG(RTMSDFEditor, Warning, TEXT("%s : %s has a single channel source, so Separate Channels is imported as Single Channel"), ANSI_TO_TCHAR(__FUNCTION__), *texture->GetName());
 			importerSettings.Format = ERTMSDF_SDFFormat::SingleChannel;
+		}
 
 		const int numSDFChannels = (forceSingleChannelOutput || IsSingleChannelFormat(importerSettings.Format)) ? 1 : 4;
-		ETextureSourceFormat sdfFormat = numSDFChannels == 1 ? TSF_G8 : TSF_BGRA8;
+		ETextureSourceFormat sdfFormat = numSDFChannels == 1 ? GetSingleChannelSourceFormat(importerSettings.Format) : TSF_BGRA8;
 		TArray<ERTMSDF_Channels, TFixedAllocator<4>> sdfChannelColors;
 		GetTextureFormat(sdfFormat, sdfChannelColors);
 		ensureAlways(numSDFChannels == sdfChannelColors.Num());
@@ -148,10 +211,19 @@ namespace RTM::SDF::TexturePostProcess
 		const FSDFBufferDef sourceBufferDef(sourceWidth, sourceHeight, numSourceChannels, sourceFormat);
 		const FSDFBufferDef sdfBufferDef(sourceBufferDef.Width * scale, sourceBufferDef.Height * scale, numSDFChannels, sdfFormat);
 
+		const bool traceToMSDF = !forceSingleChannelOutput
+			&& (importerSettings.Format == ERTMSDF_SDFFormat::Multichannel || importerSettings.Format == ERTMSDF_SDFFormat::MultichannelPlusAlpha);
+
+		if(traceToMSDF)
+		{
+			const int sourceChannelIdx = sourceChannelColors.Find(importerSettings.GetChannelMapping(ERTMSDF_Channels::Red));
+			PopulateMSDFFromBitmap(texture, mip, sourceBufferDef, sourceChannelIdx, importerSettings);
+		}
+		else
 		{
 			// TODO - work out how to map this better than what we are doing. Probably roll into the non-square update?
 
-			const int bufferLen = sdfBufferDef.GetBufferLen();
+			const size_t bufferLen = GetBufferSize(sdfBufferDef);
 			uint8* sdfPixels = static_cast<uint8*>(FMemory::Malloc(bufferLen));
 			ON_SCOPE_EXIT { FMemory::Free(sdfPixels); };
 
@@ -161,6 +233,23 @@ namespace RTM::SDF::TexturePostProcess
 			const bool tileX = texture->AddressX == TA_Wrap;
 			const bool tileY = texture->AddressY == TA_Wrap;
 
+			// All SDF channels are generated together, so the source is only read once and identical channels are only generated once
+			TArray<FSDFBufferMapping> sdfMappings;
+			for(int i = 0; i < numSDFChannels; ++i)
+			{
+				const ERTMSDF_Channels sourceChannel = importerSettings.GetChannelMapping(sdfChannelColors[i]);
+				const int sourceChannelIdx = sourceChannelColors.Find(sourceChannel);
+				if(sourceChannelIdx != INDEX_NONE && importerSettings.GetChannelBehavior(sourceChannel) == ERTMSDF_BitmapChannelBehavior::SDF)
+					sdfMappings.Add(FSDFBufferMapping(sourceChannelIdx, i, normalizedDistance, tileX, tileY, sdfAreaScale, importerSettings.bInvertDistance));
+			}
+
+			const auto* editorSettings = GetDefault<URTMSDF_PerUserEditorSettings>();
+			const int searchTileSize = editorSettings && editorSettings->BitmapSearchTileSize > 0 ? editorSettings->BitmapSearchTileSize : FindBestSearchTileSize();
+
+			TArray<bool> sdfSuccess;
+			if(sdfMappings.Num() > 0)
+				CreateDistanceFields(mip, sourceBufferDef, sdfPixels, sdfBufferDef, sdfMappings, importerSettings.DistanceEngine, sdfSuccess, importerSettings.GenerationTileSize, searchTileSize, importerSettings.EdgeSimplificationTolerance);
+
 			for(int i = 0; i < numSDFChannels; ++i)
 			{
 				const auto sdfChannel = sdfChannelColors[i];
@@ -174,8 +263,8 @@ namespace RTM::SDF::TexturePostProcess
 				{
 					if(behavior == ERTMSDF_BitmapChannelBehavior::SDF)
 					{
-						const FSDFBufferMapping bufferMap(sourceChannelIdx, i, normalizedDistance, tileX, tileY, sdfAreaScale, importerSettings.bInvertDistance);
-						const bool success = CreateDistanceField(mip, sourceBufferDef, sdfPixels, sdfBufferDef, bufferMap);
+						const int mappingIdx = sdfMappings.IndexOfByPredicate([i](const FSDFBufferMapping& mapping) { return mapping.TargetChannel == i; });
+						const bool success = ensureAlways(mappingIdx != INDEX_NONE) && sdfSuccess[mappingIdx];
 						if(!success)
 							behavior = ERTMSDF_BitmapChannelBehavior::Discard;
 					}
@@ -204,7 +293,7 @@ namespace RTM::SDF::TexturePostProcess
 			texture->Source.Init(sdfBufferDef.Width, sdfBufferDef.Height, 1, 1, sdfFormat, sdfPixels);
 		}
 
-		textureSettings.CompressionSettings = numSDFChannels == 1 ? TC_Grayscale : TC_EditorIcon;
+		textureSettings.CompressionSettings = numSDFChannels == 1 ? MSDFTextureHelpers::GetSingleChannelCompressionSettings(sdfFormat) : TC_EditorIcon;
 
 		auto* assetData = texture->GetAssetUserData<URTMSDF_BitmapGenerationAssetData>();
 		if(!assetData)
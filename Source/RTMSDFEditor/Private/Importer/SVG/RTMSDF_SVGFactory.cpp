@@ -17,6 +17,7 @@
 #include "MSDF/RTMSDF_MSDFGenerationHelpers.h"
 #include "MSDF/RTMSDF_MSDFTextureHelpers.h"
 #include "Runtime/Launch/Resources/Version.h"
+#include "Settings/RTMSDF_PerUserEditorSettings.h"
 #include "Settings/RTMSDF_ProjectSettings.h"
 #include "UObject/UObjectIterator.h"
 
@@ -127,8 +128,17 @@ UObject* URTMSDF_SVGFactory::FactoryCreateBinary(UClass* inClass, UObject* inPar
 	const SDFTransformation sdfTransformation = CalculateTransformation(svgSize, importerSettings.TextureSize, importerSettings.bScaleToFitDistance, range, sdfSize);
 	MSDFGeneratorConfig generatorConfig;
 	generatorConfig.overlapSupport = true;
+	if(const auto* editorSettings = GetDefault<URTMSDF_PerUserEditorSettings>())
+	{
+		generatorConfig.threadCount = editorSettings->MaxGenerationThreads;
+		generatorConfig.useEdgeIndex = editorSettings->bUseEdgeIndex;
+		generatorConfig.useCompiledShape = editorSettings->bUseCompiledShape;
+	}
 
 	ApplyErrorCorrectionModeTo(generatorConfig.errorCorrection, importerSettings.ErrorCorrectionMode);
+	ApplyCurveDistanceQualityTo(generatorConfig, importerSettings.CurveDistanceQuality);
+	generatorConfig.errorCorrection.useNearestEdges = importerSettings.bNearestEdgeErrorCorrection;
+	generatorConfig.singlePrecision = importerSettings.bSinglePrecision && importerSettings.Format != ERTMSDF_SDFFormat::SingleChannel16 && importerSettings.Format != ERTMSDF_SDFFormat::SingleChannelHalf;
 	PopulateSDFTextureSourceData(importerSettings.Format, generatorConfig, sdfSize, shape, sdfTransformation, importerSettings.bInvertDistance, texture);
 
 	UpdateNewTextureSettings(texture, textureSettings, importerSettings.Format);
@@ -9,9 +9,14 @@
 #include "ChlumskyMSDFGen/Public/Ext/import-svg.h"
 #include "Core/Bitmap.h"
 #include "Core/edge-coloring.h"
+#include "Core/ShapeDistanceFinder.h"
 #include "Core/SDFTransformation.h"
+#include "Generation/Bitmap/RTMSDF_BitmapGeneration.h"
+#include "Generation/Common/RTMSDF_Buffers.h"
+#include "Generation/Common/RTMSDF_PixelFormats.h"
 #include "Generation/Common/RTMSDF_SDFFormat.h"
 #include "Generation/SVG/RTM_MSDFEnums.h"
+#include "Settings/RTMSDF_PerUserEditorSettings.h"
 
 namespace RTM::SDF::MSDFGenerationHelpers
 {
@@ -38,6 +43,178 @@ namespace RTM::SDF::MSDFGenerationHelpers
 		return success;
 	}
 
+	static Point2 ToPoint2(const FVector2D& point) { return Point2(point.X, point.Y); }
+
+	static void AddFittedContour(Shape& shape, TArray<FVector2D>& points, double cornerCos)
+	{
+		// Tracing cuts sharp corners off with a short chamfer. Where the edges either side of one turn by a corner's worth between them, extend them to meet again
+		constexpr double maxChamferLength = 1.5;
+		for(int32 i = 0; i < points.Num() && points.Num() > 3; ++i)
+		{
+			const int32 n = points.Num();
+			const FVector2D& a = points[(i + n - 1) % n];
+			const FVector2D& b = points[i];
+			const FVector2D& c = points[(i + 1) % n];
+			const FVector2D& d = points[(i + 2) % n];
+
+			const FVector2D inDir = (b - a).GetSafeNormal();
+			const FVector2D outDir = (d - c).GetSafeNormal();
+			const double cross = FVector2D::CrossProduct(inDir, outDir);
+			if(FVector2D::Distance(b, c) > maxChamferLength || FVector2D::DotProduct(inDir, outDir) > cornerCos || FMath::Abs(cross) < UE_KINDA_SMALL_NUMBER)
+				continue;
+
+			const FVector2D corner = b + inDir * (FVector2D::CrossProduct(c - b, outDir) / cross);
+			if(FVector2D::Distance(corner, (b + c) * 0.5) > maxChamferLength)
+				continue;
+
+			points[i] = corner;
+			points.RemoveAt((i + 1) % n);
+		}
+
+		const int32 n = points.Num();
+		if(n < 3)
+			return;
+
+		TArray<bool> isCorner;
+		isCorner.SetNumUninitialized(n);
+		for(int32 i = 0; i < n; ++i)
+		{
+			const FVector2D inDir = (points[i] - points[(i + n - 1) % n]).GetSafeNormal();
+			const FVector2D outDir = (points[(i + 1) % n] - points[i]).GetSafeNormal();
+			isCorner[i] = FVector2D::DotProduct(inDir, outDir) < cornerCos;
+		}
+
+		auto midPoint = [&points, n](int32 i, int32 j) { return (points[i % n] + points[j % n]) * 0.5; };
+
+		Contour& contour = shape.addContour();
+		const int32 firstCorner = isCorner.Find(true);
+		if(firstCorner == INDEX_NONE)
+		{
+			// Smooth all the way round - a closed spline of curves through the midpoints of the polyline
+			for(int32 i = 0; i < n; ++i)
+				contour.addEdge(EdgeHolder(ToPoint2(midPoint(i + n - 1, i)), ToPoint2(points[i]), ToPoint2(midPoint(i, i + 1))));
+
+			return;
+		}
+
+		// Between corners, single segments stay as lines and longer runs become a spline of curves, which starts and ends exactly on the corners
+		int32 runStart = firstCorner;
+		do
+		{
+			int32 runEnd = runStart + 1;
+			while(!isCorner[runEnd % n])
+				++runEnd;
+
+			if(runEnd - runStart == 1)
+			{
+				contour.addEdge(EdgeHolder(ToPoint2(points[runStart % n]), ToPoint2(points[runEnd % n])));
+			}
+			else
+			{
+				for(int32 i = runStart + 1; i < runEnd; ++i)
+				{
+					const FVector2D start = i == runStart + 1 ? points[runStart % n] : midPoint(i - 1, i);
+					const FVector2D end = i == runEnd - 1 ? points[runEnd % n] : midPoint(i, i + 1);
+					contour.addEdge(EdgeHolder(ToPoint2(start), ToPoint2(points[i % n]), ToPoint2(end)));
+				}
+			}
+
+			runStart = runEnd;
+		} while(runStart % n != firstCorner);
+	}
+
+	bool CreateShape(const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, int channelOffset, float fitTolerance, double angleThreshold, Shape& outShape)
+	{
+		// Pad with a border of empty pixels so shapes touching the edge of the source are closed along it. 16 bits keeps the precision of every source format
+		// Values exactly on the threshold are nudged inside, so no edge passes through a pixel centre and every contour chains all the way round
+		const FSDFBufferDef paddedBufferDef{sourceBufferDef.Width + 2, sourceBufferDef.Height + 2, 1, TSF_G16};
+		TArray<uint16> padded;
+		padded.SetNumZeroed(paddedBufferDef.Width * paddedBufferDef.Height);
+
+		constexpr uint16 threshold = static_cast<uint16>(TChannelTraits<uint16>::Threshold);
+		const bool supported = VisitPixelFormat(sourceBufferDef, [&](auto format)
+		{
+			using TFormat = decltype(format);
+			const auto* typedSource = reinterpret_cast<const typename TFormat::TChannel*>(sourceBuffer);
+			for(int y = 0; y < sourceBufferDef.Height; ++y)
+			{
+				for(int x = 0; x < sourceBufferDef.Width; ++x)
+				{
+					const uint16 value = static_cast<uint16>(FMath::RoundToInt(TFormat::ToUnit(typedSource[(static_cast<size_t>(y) * sourceBufferDef.Width + x) * TFormat::NumChannels + channelOffset]) * 65535.0f));
+					padded[(y + 1) * paddedBufferDef.Width + x + 1] = value == threshold ? threshold + 1 : value;
+				}
+			}
+		});
+
+		if(!supported)
+			return false;
+
+		auto paddedValue = [&padded, &paddedBufferDef](int x, int y) { return padded[(y + 1) * paddedBufferDef.Width + x + 1]; };
+		const uint16 maxValue = FMath::Max(padded);
+
+		TArray<FVector2f> edgePoints;
+		const uint8* paddedBuffer = reinterpret_cast<const uint8*>(padded.GetData());
+		TArray<TArray<FVector2f>> polylines;
+		if(!FindEdges(paddedBuffer, paddedBufferDef, 0, edgePoints) || !TraceContours(edgePoints, fitTolerance, polylines))
+			return false;
+
+		outShape = Shape();
+		outShape.inverseYAxis = false;		// Source rows run downwards, the same as SVG shapes once CreateShape has flipped them
+
+		const double cornerCos = FMath::Cos(PI - angleThreshold);
+		int numOpenPolylines = 0;
+		for(const TArray<FVector2f>& polyline : polylines)
+		{
+			if(polyline.Num() < 4 || polyline[0] != polyline.Last())
+			{
+				++numOpenPolylines;
+				continue;
+			}
+
+			// Padded pixel centres sit at half a pixel in the shape, so the shape covers the whole of each source pixel. The closing point repeats the first
+			TArray<FVector2D> points;
+			points.Reserve(polyline.Num() - 1);
+			for(int i = 0; i < polyline.Num() - 1; ++i)
+				points.Add(FVector2D(polyline[i]) - FVector2D(0.5));
+
+			AddFittedContour(outShape, points, cornerCos);
+		}
+
+		if(numOpenPolylines > 0)
+			UE_LOG(RTMSDFEditor, Warning, TEXT("%s : Skipped %d contours that did not close"), ANSI_TO_TCHAR(__FUNCTION__), numOpenPolylines);
+
+		if(outShape.contours.empty())
+			return false;
+
+		// Contours are traced in no particular direction. Orient them consistently, then check the brightest source pixels come out inside
+		outShape.orientContours();
+
+		constexpr int maxSamples = 16;
+		int numSamples = 0;
+		int numInside = 0;
+		for(int y = 0; y < sourceBufferDef.Height && numSamples < maxSamples; ++y)
+		{
+			for(int x = 0; x < sourceBufferDef.Width && numSamples < maxSamples; ++x)
+			{
+				if(paddedValue(x, y) != maxValue)
+					continue;
+
+				++numSamples;
+				if(SimpleTrueShapeDistanceFinder::oneShotDistance(outShape, Point2(x + 0.5, y + 0.5)) > 0.0)
+					++numInside;
+			}
+		}
+
+		if(numInside * 2 < numSamples)
+		{
+			for(Contour& contour : outShape.contours)
+				contour.reverse();
+		}
+
+		outShape.normalize();
+		return outShape.validate();
+	}
+
 	void DoEdgeColoring(Shape& shape, ERTMSDF_MSDFColoringMode mode, double angleThreshold, int64 seed)
 	{
 		switch(mode)
@@ -122,6 +299,28 @@ namespace RTM::SDF::MSDFGenerationHelpers
 		}
 	}
 
+	void ApplyCurveDistanceQualityTo(GeneratorConfig& config, ERTMSDF_CurveDistanceQuality quality)
+	{
+		switch(quality)
+		{
+			case ERTMSDF_CurveDistanceQuality::High:
+				config.cubicSearch = GeneratorConfig::UNIFORM_CUBIC_SEARCH;
+				break;
+
+			case ERTMSDF_CurveDistanceQuality::Fast:
+				config.cubicSearch = GeneratorConfig::BRACKETED_CUBIC_SEARCH;
+				break;
+
+			default:
+				static_assert(static_cast<int>(ERTMSDF_CurveDistanceQuality::MAX) == 2);
+
+				const int enumIntValue = static_cast<int>(quality);
+				const auto* uenumPtr = StaticEnum<ERTMSDF_CurveDistanceQuality>();
+				const FString enumName = uenumPtr->GetNameStringByValue(enumIntValue);
+				ensureAlwaysMsgf(false, TEXT("Unknown Curve Distance Quality requested ('%s' - %d)- skipping"), *enumName, enumIntValue);
+		}
+	}
+
 	SDFTransformation CalculateTransformation(Vector2 svgSize, int sdfSize, bool scaleToFitDistance, double absoluteRange, Vector2& outSDFSize)
 	{
 		const double svgMinEdge = FMath::Min(svgSize.x, svgSize.y);
@@ -138,70 +337,54 @@ namespace RTM::SDF::MSDFGenerationHelpers
 		return SDFTransformation(projection, Range(-absoluteRange, absoluteRange) * rangeAdjustment);
 	}
 
-	void Generate(ERTMSDF_SDFFormat format, const MSDFGeneratorConfig& generatorConfig, Vector2 sdfDims, const Shape& shape, const SDFTransformation& transformation, bool invertDistance, UTexture2D* outTexture)
+	/* When single precision verification is enabled, regenerates sdf in double precision and logs how far apart the two are once quantized to 8 bits
+	 * generate fills the reference bitmap using the config it's given */
+	template<int N, typename TGenerate>
+	static void VerifySinglePrecision(const TCHAR* sdfType, const MSDFGeneratorConfig& generatorConfig, const Bitmap<float, N>& sdf, TGenerate&& generate)
 	{
-		// TODO - really need to separate out the texture stuff here from the generation. It's sort of done for the individual generations, just needs some cleanup
-
-		switch(format)
+		const auto* editorSettings = GetDefault<URTMSDF_PerUserEditorSettings>();
+		if(!generatorConfig.useCompiledShape || !generatorConfig.singlePrecision || !editorSettings || !editorSettings->bVerifySinglePrecision)
+			return;
+
+		MSDFGeneratorConfig doubleConfig = generatorConfig;
+		doubleConfig.singlePrecision = false;
+		Bitmap<float, N> reference(sdf.width(), sdf.height());
+		generate(reference, doubleConfig);
+
+		int maxDifference = 0;
+		int numDiffering = 0;
+		for(int y = 0; y < sdf.height(); y++)
 		{
-			case ERTMSDF_SDFFormat::SingleChannel:
+			for(int x = 0; x < sdf.width(); x++)
+			{
+				for(int channel = 0; channel < N; ++channel)
 				{
-					Bitmap<float, 1> sdf = GenerateSingleChannelSDF(generatorConfig, sdfDims, shape, transformation);
-					uint8* pixelData = (uint8*)malloc(sdfDims.x * sdfDims.y);
-					ExtractSDFData<1, 1>(sdf, invertDistance, pixelData);
-
-					outTexture->Source.Init(sdfDims.x, sdfDims.y, 1, 1, TSF_G8, pixelData);
-					free(pixelData);
-				}
-				break;
-
-			case ERTMSDF_SDFFormat::SingleChannelPseudo:
-				{
-					Bitmap<float, 1> sdf = GenerateSingleChannelPseudoSDF(generatorConfig, sdfDims, shape, transformation);
-					uint8* pixelData = (uint8*)malloc(sdfDims.x * sdfDims.y);
-					ExtractSDFData<1, 1>(sdf, invertDistance, pixelData);
-
-					outTexture->Source.Init(sdfDims.x, sdfDims.y, 1, 1, TSF_G8, pixelData);
-					free(pixelData);
+					const int difference = FMath::Abs(pixelFloatToByte(sdf(x, y)[channel]) - pixelFloatToByte(reference(x, y)[channel]));
+					maxDifference = FMath::Max(maxDifference, difference);
+					numDiffering += difference != 0;
 				}
-				break;
-
-			case ERTMSDF_SDFFormat::Multichannel:
-				{
-					Bitmap<float, 3> sdf = GenerateMSDF(generatorConfig, sdfDims, shape, transformation);
-					uint8* pixelData = (uint8*)malloc(sdfDims.x * sdfDims.y * 4);
-					ExtractSDFData<3, 4>(sdf, invertDistance, pixelData);
-
-					outTexture->Source.Init(sdfDims.x, sdfDims.y, 1, 1, TSF_BGRA8, pixelData);
-					free(pixelData);
-				}
-				break;
-
-			case ERTMSDF_SDFFormat::MultichannelPlusAlpha:
-				{
-					Bitmap<float, 4> sdf = GenerateMTSDF(generatorConfig, sdfDims, shape, transformation);
-					uint8* pixelData = (uint8*)malloc(sdfDims.x * sdfDims.y * 4);
-					ExtractSDFData<4, 4>(sdf, invertDistance, pixelData);
-
-					outTexture->Source.Init(sdfDims.x, sdfDims.y, 1, 1, TSF_BGRA8, pixelData);
-					free(pixelData);
-				}
-				break;
-
-			default:
-				static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 5);
+			}
+		}
 
-				const int enumIntValue = static_cast<int>(format);
-				const auto* uenumPtr = StaticEnum<ERTMSDF_MSDFErrorCorrectionMode>();
-				const FString enumName = uenumPtr->GetNameStringByValue(enumIntValue);
-				ensureAlwaysMsgf(false, TEXT("Unknown MSDF Format requested ('%s' - %d)- skipping"), *enumName, enumIntValue);;
+		const int numValues = sdf.width() * sdf.height() * N;
+		if(maxDifference > 1)
+		{
+			UE_LOG(RTMSDFEditor, Warning, TEXT("Single precision %s differs from double precision by up to %d steps (%d of %d values differ)"), sdfType, maxDifference, numDiffering, numValues);
+		}
+		else
+		{
+			UE_LOG(RTMSDFEditor, Log, TEXT("Single precision %s is within %d step of double precision (%d of %d values differ)"), sdfType, maxDifference, numDiffering, numValues);
 		}
 	}
 
 	Bitmap<float, 1> GenerateSingleChannelSDF(const MSDFGeneratorConfig& generatorConfig, Vector2 sdfDims, const Shape& shape, const SDFTransformation& transformation)
 	{
 		Bitmap<float, 1> sdf(sdfDims.x, sdfDims.y);
+		const uint64 cyclesStart = FPlatformTime::Cycles();
 		generateSDF(sdf, shape, transformation, generatorConfig);
+		const uint64 cyclesEnd = FPlatformTime::Cycles();
+		UE_LOG(RTMSDFEditor, Verbose, TEXT("Generated SDF from %d edges, edge index %s, compiled shape %s%s (%.2fms)"), shape.edgeCount(), generatorConfig.useEdgeIndex ? TEXT("enabled") : TEXT("disabled"), generatorConfig.useCompiledShape ? TEXT("enabled") : TEXT("disabled"), generatorConfig.useCompiledShape && generatorConfig.singlePrecision ? TEXT(" (single precision)") : TEXT(""), FPlatformTime::ToMilliseconds(cyclesEnd-cyclesStart));
+		VerifySinglePrecision(TEXT("SDF"), generatorConfig, sdf, [&](Bitmap<float, 1>& reference, const MSDFGeneratorConfig& config) { generateSDF(reference, shape, transformation, config); });
 		return sdf;
 	}
 
@@ -209,6 +392,7 @@ namespace RTM::SDF::MSDFGenerationHelpers
 	{
 		Bitmap<float, 1> psdf(sdfDims.x, sdfDims.y);
 		generatePSDF(psdf, shape, transformation, generatorConfig);
+		VerifySinglePrecision(TEXT("pseudo SDF"), generatorConfig, psdf, [&](Bitmap<float, 1>& reference, const MSDFGeneratorConfig& config) { generatePSDF(reference, shape, transformation, config); });
 		return psdf;
 	}
 
@@ -216,6 +400,7 @@ namespace RTM::SDF::MSDFGenerationHelpers
 	{
 		Bitmap<float, 3> msdf(sdfDims.x, sdfDims.y);
 		generateMSDF(msdf, shape, transformation, generatorConfig);
+		VerifySinglePrecision(TEXT("MSDF"), generatorConfig, msdf, [&](Bitmap<float, 3>& reference, const MSDFGeneratorConfig& config) { generateMSDF(reference, shape, transformation, config); });
 		return msdf;
 	}
 
@@ -223,6 +408,7 @@ namespace RTM::SDF::MSDFGenerationHelpers
 	{
 		Bitmap<float, 4> mtsdf(sdfDims.x, sdfDims.y);
 		generateMTSDF(mtsdf, shape, transformation, generatorConfig);
+		VerifySinglePrecision(TEXT("MTSDF"), generatorConfig, mtsdf, [&](Bitmap<float, 4>& reference, const MSDFGeneratorConfig& config) { generateMTSDF(reference, shape, transformation, config); });
 		return mtsdf;
 	}
 
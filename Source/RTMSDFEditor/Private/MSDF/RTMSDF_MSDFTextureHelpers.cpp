@@ -6,6 +6,7 @@
 #include "Importer/Common/RTMSDFTextureSettingsCache.h"
 #include "Core/Bitmap.h"
 #include "Generation/Common/RTMSDF_SDFFormat.h"
+#include "Generation/Common/RTMSDF_PixelFormats.h"
 #include "MSDF/RTMSDF_MSDFGenerationHelpers.h"
 #include "Generation/SVG/RTM_MSDFEnums.h"
 
@@ -13,6 +14,20 @@ namespace RTM::SDF::MSDFTextureHelpers
 {
 	using namespace msdfgen;
 
+	// Wider equivalent of ExtractSDFData<1, 1>, quantized the same way as bitmap SDFs of the same format
+	template<typename TChannel>
+	static void ExtractSingleChannelSDFData(const BitmapConstRef<float, 1> sdf, bool invert, TChannel* outBuffer)
+	{
+		for(int y = 0; y < sdf.height; y++)
+		{
+			for(int x = 0, nx = sdf.width; x < nx; x++)
+			{
+				const float value = *sdf(x, y);
+				outBuffer[y * nx + x] = TChannelTraits<TChannel>::FromUnit(invert ? value : 1.0f - value);
+			}
+		}
+	}
+
 	void PopulateSDFTextureSourceData(ERTMSDF_SDFFormat format, const MSDFGeneratorConfig& generatorConfig, Vector2 sdfDims, const Shape& shape, const SDFTransformation& transformation, bool invertDistance, UTexture2D* texture)
 	{
 		using namespace MSDFGenerationHelpers;
@@ -43,6 +58,24 @@ namespace RTM::SDF::MSDFTextureHelpers
 				}
 				break;
 
+			case ERTMSDF_SDFFormat::SingleChannel16:
+			case ERTMSDF_SDFFormat::SingleChannelHalf:
+				{
+					Bitmap<float, 1> sdf = GenerateSingleChannelSDF(generatorConfig, sdfDims, shape, transformation);
+					const FSDFBufferDef sdfBufferDef{static_cast<int32>(sdfDims.x), static_cast<int32>(sdfDims.y), 1, GetSingleChannelSourceFormat(format)};
+					uint8* pixelData = static_cast<uint8*>(FMemory::Malloc(GetBufferSize(sdfBufferDef)));
+
+					VisitPixelFormat(sdfBufferDef, [&](auto pixelFormat)
+					{
+						using TChannel = typename decltype(pixelFormat)::TChannel;
+						ExtractSingleChannelSDFData<TChannel>(sdf, invertDistance, reinterpret_cast<TChannel*>(pixelData));
+					});
+					texture->Source.Init(sdfDims.x, sdfDims.y, 1, 1, sdfBufferDef.Format, pixelData);
+
+					FMemory::Free(pixelData);
+				}
+				break;
+
 			case ERTMSDF_SDFFormat::Multichannel:
 				{
 					Bitmap<float, 3> sdf = GenerateMSDF(generatorConfig, sdfDims, shape, transformation);
@@ -68,7 +101,7 @@ namespace RTM::SDF::MSDFTextureHelpers
 				break;
 
 			default:
-				static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 5);
+				static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 7);
 
 				const int enumIntValue = static_cast<int>(format);
 				const auto* uenumPtr = StaticEnum<ERTMSDF_MSDFErrorCorrectionMode>();
@@ -89,13 +122,18 @@ namespace RTM::SDF::MSDFTextureHelpers
 				texture->CompressionSettings = TC_Grayscale;
 				break;
 
+			case ERTMSDF_SDFFormat::SingleChannel16:
+			case ERTMSDF_SDFFormat::SingleChannelHalf:
+				texture->CompressionSettings = GetSingleChannelCompressionSettings(GetSingleChannelSourceFormat(format));
+				break;
+
 			case ERTMSDF_SDFFormat::Multichannel:
 			case ERTMSDF_SDFFormat::MultichannelPlusAlpha:
 				texture->CompressionSettings = TC_EditorIcon;
 				break;
 
 			default:
-				static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 5);
+				static_assert(static_cast<int>(ERTMSDF_SDFFormat::MAX) == 7);
 
 				const int enumIntValue = static_cast<int>(format);
 				const auto* uenumPtr = StaticEnum<ERTMSDF_MSDFErrorCorrectionMode>();
@@ -110,4 +148,14 @@ namespace RTM::SDF::MSDFTextureHelpers
 		texture->SRGB = false;
 		texture->bFlipGreenChannel = false;
 	}
+
+	TextureCompressionSettings GetSingleChannelCompressionSettings(ETextureSourceFormat sdfFormat)
+	{
+		// Grayscale keeps 16 bit sources at 16 bits, but would quantize half floats
+#if RTMSDF_WITH_R16F_SOURCE
+		if(sdfFormat == TSF_R16F)
+			return TC_HalfFloat;
+#endif
+		return TC_Grayscale;
+	}
 }
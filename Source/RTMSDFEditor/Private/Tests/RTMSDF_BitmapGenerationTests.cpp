@@ -0,0 +1,102 @@
+﻿// Copyright (c) Richard Meredith AB. All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+#include "Generation/Bitmap/RTMSDF_BitmapGeneration.h"
+#include "Generation/Bitmap/RTMSDF_BitmapGenerationSettings.h"
+#include "Generation/Common/RTMSDF_Buffers.h"
+#include "Generation/Common/RTMSDF_PixelFormats.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace RTM::SDF::Tests
+{
+	// A small square near the bottom right corner of the source, with a distance range that stays clear of the other borders
+	constexpr int32 CornerSquareSize = 8;
+	constexpr int32 CornerSquareMargin = 8;
+	constexpr float CornerSquareHalfFieldDistance = 4.0f;
+	constexpr int32 CornerReferenceSize = 64;
+
+	static const ERTMSDF_BitmapDistanceEngine AllDistanceEngines[] = {ERTMSDF_BitmapDistanceEngine::EdgeTree, ERTMSDF_BitmapDistanceEngine::DistanceTransform, ERTMSDF_BitmapDistanceEngine::AntiAliasedDistanceTransform};
+
+	// Generates the SDF of the corner square in a width x height G8 source, into the last channel of a BGRA8 SDF, so the furthest pixel has the largest index any SDF of that size can have
+	static bool GenerateCornerSquareSDF(int32 width, int32 height, ERTMSDF_BitmapDistanceEngine engine, int tileSize, TArray64<uint8>& outSDF)
+	{
+		const FSDFBufferDef sourceBufferDef{width, height, 1, TSF_G8};
+		const FSDFBufferDef sdfBufferDef{width, height, 4, TSF_BGRA8};
+
+		TArray64<uint8> source;
+		source.SetNumZeroed(sourceBufferDef.GetBufferLen());
+		for(int32 y = height - CornerSquareMargin - CornerSquareSize; y < height - CornerSquareMargin; ++y)
+		{
+			for(int32 x = width - CornerSquareMargin - CornerSquareSize; x < width - CornerSquareMargin; ++x)
+				source[static_cast<int64>(y) * width + x] = 255;
+		}
+
+		outSDF.SetNumZeroed(sdfBufferDef.GetBufferLen());
+		const TArray<FSDFBufferMapping> mappings = {FSDFBufferMapping(0, 3, CornerSquareHalfFieldDistance / FMath::Min(width, height))};
+		TArray<bool> success;
+		return CreateDistanceFields(source.GetData(), sourceBufferDef, outSDF.GetData(), sdfBufferDef, mappings, engine, success, tileSize, 64) && success[0];
+	}
+
+	// Largest difference in the last channel between the overlapping bottom right corners of two BGRA8 SDFs
+	static int GetMaxCornerDifference(const TArray64<uint8>& a, int32 aWidth, int32 aHeight, const TArray64<uint8>& b, int32 bWidth, int32 bHeight)
+	{
+		auto value = [](const TArray64<uint8>& sdf, int32 width, int32 height, int32 dx, int32 dy) { return sdf[((static_cast<int64>(height) - 1 - dy) * width + width - 1 - dx) * 4 + 3]; };
+
+		int maxDifference = 0;
+		for(int32 dy = 0; dy < FMath::Min(aHeight, bHeight); ++dy)
+		{
+			for(int32 dx = 0; dx < FMath::Min(aWidth, bWidth); ++dx)
+				maxDifference = FMath::Max(maxDifference, FMath::Abs(value(a, aWidth, aHeight, dx, dy) - value(b, bWidth, bHeight, dx, dy)));
+		}
+
+		return maxDifference;
+	}
+
+	// Compares the corner of a width x height SDF with the same square generated in a small reference SDF, for every engine, with and without tiling
+	static void TestCornerSquare(FAutomationTestBase& test, int32 width, int32 height, int tileSize)
+	{
+		for(const ERTMSDF_BitmapDistanceEngine engine : AllDistanceEngines)
+		{
+			TArray64<uint8> reference;
+			GenerateCornerSquareSDF(CornerReferenceSize, CornerReferenceSize, engine, 0, reference);
+
+			for(const int tiles : {0, tileSize})
+			{
+				TArray64<uint8> sdf;
+				const bool success = GenerateCornerSquareSDF(width, height, engine, tiles, sdf);
+				test.TestTrue(FString::Printf(TEXT("Found the square in %dx%d with engine %d, tile size %d"), width, height, static_cast<int>(engine), tiles), success);
+
+				// Positions far from the origin lose a little float precision, so distances may round to the neighbouring 8 bit value
+				const int maxDifference = GetMaxCornerDifference(sdf, width, height, reference, CornerReferenceSize, CornerReferenceSize);
+				test.TestTrue(FString::Printf(TEXT("Corner of %dx%d matches the reference with engine %d, tile size %d (max difference %d)"), width, height, static_cast<int>(engine), tiles, maxDifference), maxDifference <= 1);
+				test.TestEqual(FString::Printf(TEXT("Top left of %dx%d is out of range with engine %d, tile size %d"), width, height, static_cast<int>(engine), tiles), static_cast<int>(sdf[3]), 255);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTMSDF_BitmapLargeDimensionsTest, "RTMSDF.Bitmap.LargeDimensions", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTMSDF_BitmapLargeDimensionsTest::RunTest(const FString& parameters)
+{
+	using namespace RTM::SDF::Tests;
+
+	// The largest width and height a texture can have, on sources thin enough to generate quickly
+	TestCornerSquare(*this, 32767, 32, 256);
+	TestCornerSquare(*this, 32, 32767, 256);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTMSDF_BitmapLargeAreaTest, "RTMSDF.Bitmap.LargeDimensions.LargeArea", EAutomationTestFlags::EditorContext | EAutomationTestFlags::StressFilter)
+
+bool FRTMSDF_BitmapLargeAreaTest::RunTest(const FString& parameters)
+{
+	using namespace RTM::SDF::Tests;
+
+	// Indices into the last rows of a 4 channel SDF this size are beyond the range of int32. Needs around 3GB of memory
+	TestCornerSquare(*this, 24000, 24000, 2048);
+	return true;
+}
+
+#endif
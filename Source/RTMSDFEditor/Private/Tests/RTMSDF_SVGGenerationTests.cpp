@@ -0,0 +1,263 @@
+﻿// Copyright (c) Richard Meredith AB. All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+#include "Core/Bitmap.h"
+#include "Core/msdfgen.h"
+#include "Core/SDFTransformation.h"
+#include "Core/Shape.h"
+#include "Core/edge-coloring.h"
+#include "Core/pixel-conversion.hpp"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace msdfgen;
+
+namespace RTM::SDF::Tests
+{
+	// Generates a true SDF of shape, centred in a square of size pixels, with one pixel per shape unit
+	static Bitmap<float, 1> GenerateTestSDF(const Shape& shape, int size, const GeneratorConfig& config)
+	{
+		Bitmap<float, 1> sdf(size, size);
+		const SDFTransformation transformation(Projection(Vector2(1.0), Vector2(size * 0.5)), DistanceMapping());
+		generateSDF(sdf, shape, transformation, config);
+		return sdf;
+	}
+
+	static float GetMaxDifference(const Bitmap<float, 1>& a, const Bitmap<float, 1>& b)
+	{
+		float maxDifference = 0.0f;
+		for(int y = 0; y < a.height(); ++y)
+		{
+			for(int x = 0; x < a.width(); ++x)
+				maxDifference = FMath::Max(maxDifference, FMath::Abs(*a(x, y) - *b(x, y)));
+		}
+
+		return maxDifference;
+	}
+
+	// Largest difference between a and b once both are stored as 8 bit values
+	template<int N>
+	static int GetMaxByteDifference(const Bitmap<float, N>& a, const Bitmap<float, N>& b)
+	{
+		int maxDifference = 0;
+		for(int y = 0; y < a.height(); ++y)
+		{
+			for(int x = 0; x < a.width(); ++x)
+			{
+				for(int channel = 0; channel < N; ++channel)
+					maxDifference = FMath::Max(maxDifference, FMath::Abs(pixelFloatToByte(a(x, y)[channel]) - pixelFloatToByte(b(x, y)[channel])));
+			}
+		}
+
+		return maxDifference;
+	}
+
+	// Generates with generate in single and double precision, and returns the largest 8 bit difference between them
+	template<int N, typename TGenerate>
+	static int GetSinglePrecisionByteDifference(int size, TGenerate&& generate)
+	{
+		MSDFGeneratorConfig config;
+		Bitmap<float, N> singleSDF(size, size);
+		Bitmap<float, N> doubleSDF(size, size);
+		config.singlePrecision = true;
+		generate(singleSDF, config);
+		config.singlePrecision = false;
+		generate(doubleSDF, config);
+		return GetMaxByteDifference(singleSDF, doubleSDF);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTMSDF_BracketedCubicSearchSymmetricTest, "RTMSDF.SVG.BracketedCubicSearch.SymmetricCurves", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTMSDF_BracketedCubicSearchSymmetricTest::RunTest(const FString& parameters)
+{
+	using namespace RTM::SDF::Tests;
+
+	// Arches are symmetric about the centre column of pixels, where the distance to the curve is stationary exactly at t = 0.5, one of the section bounds
+	// Odd sizes put that column exactly on the axis of symmetry
+	// The uniform search itself only converges to around a thousandth of a pixel on tightly bent arches, so that is all the two are expected to agree to
+	constexpr int size = 33;
+	constexpr float tolerance = 0.01f;
+	const GeneratorConfig uniformConfig(true, 0, true, true, false, GeneratorConfig::UNIFORM_CUBIC_SEARCH);
+	const GeneratorConfig bracketedConfig(true, 0, true, true, false, GeneratorConfig::BRACKETED_CUBIC_SEARCH);
+	for(const double halfWidth : {4.0, 8.0, 15.0})
+	{
+		for(const double height : {-12.0, -3.0, 3.0, 12.0})
+		{
+			for(const bool vertical : {false, true})
+			{
+				auto point = [vertical](double x, double y) { return vertical ? Point2(y, x) : Point2(x, y); };
+
+				Shape shape;
+				Contour& contour = shape.addContour();
+				contour.addEdge(EdgeHolder(point(-halfWidth, 0.0), point(-halfWidth, height), point(halfWidth, height), point(halfWidth, 0.0)));
+				contour.addEdge(EdgeHolder(point(halfWidth, 0.0), point(-halfWidth, 0.0)));
+				shape.orientContours();
+
+				const float maxDifference = GetMaxDifference(GenerateTestSDF(shape, size, uniformConfig), GenerateTestSDF(shape, size, bracketedConfig));
+				TestTrue(FString::Printf(TEXT("Bracketed search matches uniform search for arch %.0fx%.0f%s (max difference %g)"), halfWidth * 2.0, height, vertical ? TEXT(" vertical") : TEXT(""), maxDifference), maxDifference < tolerance);
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTMSDF_SinglePrecisionTest, "RTMSDF.SVG.SinglePrecision", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTMSDF_SinglePrecisionTest::RunTest(const FString& parameters)
+{
+	using namespace RTM::SDF::Tests;
+
+	// Nearly straight curves are where the equation solvers are least accurate, as their leading coefficients almost vanish
+	// Each shape is also offset far from the origin, where single precision coordinates have the fewest fractional bits
+	auto buildShape = [](int shapeIdx, const Vector2& offset)
+	{
+		Shape shape;
+		auto point = [&offset](double x, double y) { return Point2(x, y) + offset; };
+		switch(shapeIdx)
+		{
+			case 0:
+			{
+				Contour& contour = shape.addContour();
+				contour.addEdge(EdgeHolder(point(2, 2), point(30, 2)));
+				contour.addEdge(EdgeHolder(point(30, 2), point(30.0001, 16), point(30, 30)));
+				contour.addEdge(EdgeHolder(point(30, 30), point(2, 30)));
+				contour.addEdge(EdgeHolder(point(2, 30), point(2, 2)));
+				break;
+			}
+			case 1:
+			{
+				Contour& contour = shape.addContour();
+				contour.addEdge(EdgeHolder(point(2, 2), point(12, 2.00001), point(20, 1.99999), point(30, 2)));
+				contour.addEdge(EdgeHolder(point(30, 2), point(30, 30)));
+				contour.addEdge(EdgeHolder(point(30, 30), point(2, 30)));
+				contour.addEdge(EdgeHolder(point(2, 30), point(2, 2)));
+				break;
+			}
+			case 2:
+			{
+				Contour& contour = shape.addContour();
+				contour.addEdge(EdgeHolder(point(4, 16), point(4, 4), point(28, 4), point(28, 16)));
+				contour.addEdge(EdgeHolder(point(28, 16), point(28, 28), point(4, 28), point(4, 16)));
+				break;
+			}
+			default:
+			{
+				for(const double radius : {12.0, 6.0})
+				{
+					Contour& contour = shape.addContour();
+					contour.addEdge(EdgeHolder(point(16, 16 - radius), point(16 + radius, 16 - radius), point(16 + radius, 16)));
+					contour.addEdge(EdgeHolder(point(16 + radius, 16), point(16 + radius, 16 + radius), point(16, 16 + radius)));
+					contour.addEdge(EdgeHolder(point(16, 16 + radius), point(16 - radius, 16 + radius), point(16 - radius, 16)));
+					contour.addEdge(EdgeHolder(point(16 - radius, 16), point(16 - radius, 16 - radius), point(16, 16 - radius)));
+				}
+				break;
+			}
+		}
+
+		shape.normalize();
+		shape.orientContours();
+		edgeColoringSimple(shape, 3.0);
+		return shape;
+	};
+
+	constexpr int numShapes = 4;
+	constexpr int size = 32;
+	for(const double offset : {0.0, 1000.0})
+	{
+		for(int shapeIdx = 0; shapeIdx < numShapes; ++shapeIdx)
+		{
+			const Shape shape = buildShape(shapeIdx, Vector2(offset));
+
+			// One pixel per shape unit, with a range of 4 pixels
+			const SDFTransformation transformation(Projection(Vector2(1.0), Vector2(-offset)), DistanceMapping(Range(-2.0, 2.0)));
+			auto testDifference = [&](const TCHAR* sdfType, int difference)
+			{
+				TestTrue(FString::Printf(TEXT("Single precision %s of shape %d at offset %.0f is within one 8 bit step of double precision (differs by %d)"), sdfType, shapeIdx, offset, difference), difference <= 1);
+			};
+
+			testDifference(TEXT("SDF"), GetSinglePrecisionByteDifference<1>(size, [&](Bitmap<float, 1>& sdf, const MSDFGeneratorConfig& config) { generateSDF(sdf, shape, transformation, config); }));
+			testDifference(TEXT("pseudo SDF"), GetSinglePrecisionByteDifference<1>(size, [&](Bitmap<float, 1>& sdf, const MSDFGeneratorConfig& config) { generatePSDF(sdf, shape, transformation, config); }));
+			testDifference(TEXT("MSDF"), GetSinglePrecisionByteDifference<3>(size, [&](Bitmap<float, 3>& sdf, const MSDFGeneratorConfig& config) { generateMSDF(sdf, shape, transformation, config); }));
+			testDifference(TEXT("MTSDF"), GetSinglePrecisionByteDifference<4>(size, [&](Bitmap<float, 4>& sdf, const MSDFGeneratorConfig& config) { generateMTSDF(sdf, shape, transformation, config); }));
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTMSDF_EdgeIndexTest, "RTMSDF.SVG.EdgeIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTMSDF_EdgeIndexTest::RunTest(const FString& parameters)
+{
+	using namespace RTM::SDF::Tests;
+
+	// A grid of small contours, so most edges are far from most pixels, as for SVGs with many edges
+	constexpr double cellSize = 14.0;
+	auto buildShape = [](int gridSize, int edgesPerContour)
+	{
+		Shape shape;
+		for(int cellY = 0; cellY < gridSize; ++cellY)
+		{
+			for(int cellX = 0; cellX < gridSize; ++cellX)
+			{
+				const Vector2 centre((cellX - (gridSize - 1) * 0.5) * cellSize, (cellY - (gridSize - 1) * 0.5) * cellSize);
+				auto point = [&centre, edgesPerContour](int i, double radius)
+				{
+					const double angle = 2.0 * PI * i / (edgesPerContour * 3);
+					return centre + radius * Vector2(cos(angle), sin(angle));
+				};
+
+				Contour& contour = shape.addContour();
+				for(int edge = 0; edge < edgesPerContour; ++edge)
+				{
+					const int i = edge * 3;
+					switch(edge % 3)
+					{
+						case 0: contour.addEdge(EdgeHolder(point(i, 5.0), point(i + 3, 5.0))); break;
+						case 1: contour.addEdge(EdgeHolder(point(i, 5.0), point(i + 1, 6.0), point(i + 3, 5.0))); break;
+						default: contour.addEdge(EdgeHolder(point(i, 5.0), point(i + 1, 4.0), point(i + 2, 6.0), point(i + 3, 5.0))); break;
+					}
+				}
+			}
+		}
+
+		return shape;
+	};
+
+	// Grid size and edges per contour, from tens to thousands of edges, so the speedup can be read against the edge count
+	constexpr int numCases = 4;
+	constexpr int cases[numCases][2] = {{2, 6}, {4, 12}, {8, 24}, {8, 48}};
+
+	// The index only skips edges that can't be nearer than the nearest found so far, so output must be identical with and without it
+	constexpr int size = 128;
+	for(const auto& gridCase : cases)
+	{
+		const Shape shape = buildShape(gridCase[0], gridCase[1]);
+		const int numEdges = gridCase[0] * gridCase[0] * gridCase[1];
+		for(const bool compiled : {false, true})
+		{
+			for(const bool overlapSupport : {false, true})
+			{
+				const TCHAR* description = compiled ? (overlapSupport ? TEXT("compiled, overlapping") : TEXT("compiled")) : (overlapSupport ? TEXT("overlapping") : TEXT("simple"));
+
+				const double indexedStart = FPlatformTime::Seconds();
+				const Bitmap<float, 1> indexedSDF = GenerateTestSDF(shape, size, GeneratorConfig(overlapSupport, 0, true, compiled));
+				const double indexedSeconds = FPlatformTime::Seconds() - indexedStart;
+
+				const double unindexedStart = FPlatformTime::Seconds();
+				const Bitmap<float, 1> unindexedSDF = GenerateTestSDF(shape, size, GeneratorConfig(overlapSupport, 0, false, compiled));
+				const double unindexedSeconds = FPlatformTime::Seconds() - unindexedStart;
+
+				TestEqual(FString::Printf(TEXT("Edge index output matches every edge for %d edges (%s)"), numEdges, description), GetMaxDifference(indexedSDF, unindexedSDF), 0.0f);
+				AddInfo(FString::Printf(TEXT("%d edges at %dx%d (%s): %.2fms with the edge index, %.2fms without (%.1fx)"), numEdges, size, size, description,
+					indexedSeconds * 1000.0, unindexedSeconds * 1000.0, unindexedSeconds / FMath::Max(indexedSeconds, 1e-9)));
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -9,14 +9,21 @@
 enum class ERTMSDF_SDFFormat : uint8;
 enum class ERTMSDF_MSDFColoringMode : uint8;
 enum class ERTMSDF_MSDFErrorCorrectionMode : uint8;
+enum class ERTMSDF_CurveDistanceQuality : uint8;
 enum class ERTMSDFDistanceMode : uint8;
 
 struct FRTMSDFTextureSettingsCache;
 
+namespace RTM::SDF
+{
+	struct FSDFBufferDef;
+}
+
 namespace msdfgen
 {
 	struct Vector2;
 	class SDFTransformation;
+	struct GeneratorConfig;
 	struct MSDFGeneratorConfig;
 	struct ErrorCorrectionConfig;
 
@@ -29,12 +36,16 @@ namespace RTM::SDF::MSDFGenerationHelpers
 	bool CreateShape(const uint8* svgBuffer, const uint8* bufferEnd, msdfgen::Shape& outShape, msdfgen::Shape::Bounds& outSvgBounds);
 	bool CreateShape(const uint8* svgBuffer, size_t bufferLen, msdfgen::Shape& outShape, msdfgen::Shape::Bounds& outSvgBounds);
 
+	// Traces the contours of one channel of a bitmap into lines and curves, with one shape unit per source pixel
+	bool CreateShape(const uint8* sourceBuffer, const FSDFBufferDef& sourceBufferDef, int channelOffset, float fitTolerance, double angleThreshold, msdfgen::Shape& outShape);
+
 	void DoEdgeColoring(msdfgen::Shape& shape, ERTMSDF_MSDFColoringMode mode, double angleThreshold, int64 seed = 0);
 	void DoEdgeColoringSimple(msdfgen::Shape& shape, double angleThreshold, int64 seed = 0);
 	void DoEdgeColoringInkTrap(msdfgen::Shape& shape, double angleThreshold, int64 seed = 0);
 	void DoEdgeColoringDistance(msdfgen::Shape& shape, double angleThreshold, int64 seed = 0);
 
 	void ApplyErrorCorrectionModeTo(msdfgen::ErrorCorrectionConfig& config, ERTMSDF_MSDFErrorCorrectionMode mode);
+	void ApplyCurveDistanceQualityTo(msdfgen::GeneratorConfig& config, ERTMSDF_CurveDistanceQuality quality);
 
 	msdfgen::SDFTransformation CalculateTransformation(msdfgen::Vector2 svgSize, int sdfSize, bool scaleToFitDistance, double absoluteRange, msdfgen::Vector2& outSDFSize);
 
@@ -50,7 +61,7 @@ namespace RTM::SDF::MSDFGenerationHelpers
 		{
 			for(int x = 0, nx = sdf.width; x < nx; x++)
 			{
-				const int outBufferPos = (y * nx + x) * targetWidth;
+				const size_t outBufferPos = (static_cast<size_t>(y) * nx + x) * targetWidth;
 				int channel = 0;
 				for(channel = 0; channel < sourceWidth; ++channel)
 				{
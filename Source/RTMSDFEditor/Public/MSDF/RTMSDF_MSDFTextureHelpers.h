@@ -5,6 +5,8 @@
 
 class UTexture2D;
 enum class ERTMSDF_SDFFormat : uint8;
+enum ETextureSourceFormat : int;
+enum TextureCompressionSettings : int;
 struct FRTMSDFTextureSettingsCache;
 
 namespace msdfgen
@@ -19,4 +21,5 @@ namespace RTM::SDF::MSDFTextureHelpers
 {
 	void PopulateSDFTextureSourceData(ERTMSDF_SDFFormat format, const msdfgen::MSDFGeneratorConfig& generatorConfig, msdfgen::Vector2 msdfDims, const msdfgen::Shape& shape, const msdfgen::SDFTransformation& transformation, bool invertDistance, UTexture2D* texture);
 	void UpdateNewTextureSettings(UTexture2D* texture, const FRTMSDFTextureSettingsCache& cache, ERTMSDF_SDFFormat format);
+	TextureCompressionSettings GetSingleChannelCompressionSettings(ETextureSourceFormat sdfFormat);
 }
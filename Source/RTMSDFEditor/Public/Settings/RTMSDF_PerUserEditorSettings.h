@@ -35,6 +35,31 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category="Thumbnails")
 	bool bLabelThumbnailsAsSDF = true;
 
+	/* Maximum number of threads used when generating SVG and Multichannel bitmap SDFs. 0 will use all available worker threads, 1 will generate on the game thread only
+	 * Output is identical regardless of thread count, this only trades import speed against editor responsiveness. Other bitmap formats always use all available worker threads */
+	UPROPERTY(Config, EditAnywhere, Category="Generation", meta=(UIMin=0, ClampMin=0))
+	int MaxGenerationThreads = 0;
+
+	/* Skip distant edges when generating single channel SVG SDFs, which is much faster for shapes with many edges
+	 * Output is identical either way, this is exposed only to compare generation times */
+	UPROPERTY(Config, EditAnywhere, Category="Generation", AdvancedDisplay)
+	bool bUseEdgeIndex = true;
+
+	/* Flatten SVG shapes into packed arrays of lines and curves, whose distances are evaluated several at a time with SIMD
+	 * Output is the same either way (up to floating point rounding), this is exposed only to compare generation times */
+	UPROPERTY(Config, EditAnywhere, Category="Generation", AdvancedDisplay)
+	bool bUseCompiledShape = true;
+
+	/* Regenerate SVG SDFs imported with Single Precision in double precision, and log how many 8 bit values differ between the two
+	 * Doubles generation time, this is exposed only to check single precision output against a set of SVGs */
+	UPROPERTY(Config, EditAnywhere, Category="Generation", AdvancedDisplay)
+	bool bVerifySinglePrecision = false;
+
+	/* Width and height in pixels of the blocks of a bitmap SDF that each worker thread generates at a time. 0 picks the fastest size for this machine, with a short benchmark the first time a bitmap is imported
+	 * Output is identical regardless of size, this only affects import speed */
+	UPROPERTY(Config, EditAnywhere, Category="Generation", AdvancedDisplay, meta=(UIMin=0, ClampMin=0))
+	int BitmapSearchTileSize = 0;
+
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(Transient)
 	TObjectPtr<UMaterialInterface> SDFThumbnailSingleChannel_Inst = nullptr;